@@ -1,8 +1,24 @@
 #include "AlgorithmGraph.h"
+#include "ConcurrentDisjointSet.h"
+#include "DisjointSet.h"
+#include "FlowNetwork.h"
+#include "GraphGenerator.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "Timer.h"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <iostream>
 #include <vector>
 #include <queue>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
 
 using std::cout;
 using std::endl;
@@ -12,6 +28,13 @@ using std::queue;
 using std::priority_queue;
 using sl::AlgorithmGraph;
 using sl::Graph;
+using sl::CSRGraph;
+using sl::ConcurrentDisjointSet;
+using sl::DisjointSet;
+using sl::Parallel;
+using sl::GraphGenerator;
+using sl::Timer;
+using sl::Random;
 
 AlgorithmGraph::~AlgorithmGraph() {
 }
@@ -25,6 +48,60 @@ AlgorithmGraph* AlgorithmGraph::getInstance() {
     return &instance;
 }
 
+const AlgorithmGraph::weight_type AlgorithmGraph::Workspace::INF = 2147483647;
+
+AlgorithmGraph::Workspace::Workspace() : generation(1), masked(false), maskGeneration(1) {
+}
+
+void AlgorithmGraph::Workspace::reset(const num_type n) {
+    if ((size_t)n > stamp.size()) {
+        stamp.resize(n, 0);
+        visitStamp.resize(n, 0);
+        dist.resize(n);
+        prev.resize(n);
+        count.resize(n);
+    }
+    touchedNodes.clear();
+    if (++generation == 0) {
+        // Old stamps could be taken as valid after wrapping around
+        std::fill(stamp.begin(), stamp.end(), 0);
+        std::fill(visitStamp.begin(), visitStamp.end(), 0);
+        generation = 1;
+    }
+}
+
+const vector<AlgorithmGraph::num_type>& AlgorithmGraph::Workspace::touched() const {
+    return touchedNodes;
+}
+
+void AlgorithmGraph::Workspace::clearMasks() {
+    if (!masked) {
+        return;
+    }
+    masked = false;
+    if (++maskGeneration == 0) {
+        std::fill(nodeMask.begin(), nodeMask.end(), 0);
+        std::fill(edgeMask.begin(), edgeMask.end(), 0);
+        maskGeneration = 1;
+    }
+}
+
+void AlgorithmGraph::Workspace::maskNode(const num_type v) {
+    if ((size_t)v >= nodeMask.size()) {
+        nodeMask.resize(v + 1, 0);
+    }
+    nodeMask[v] = maskGeneration;
+    masked = true;
+}
+
+void AlgorithmGraph::Workspace::maskEdge(const CSRGraph::offset_type e) {
+    if (e >= edgeMask.size()) {
+        edgeMask.resize(e + 1, 0);
+    }
+    edgeMask[e] = maskGeneration;
+    masked = true;
+}
+
 void AlgorithmGraph::test() {
     cout << "Test AlgorithmGraph:\n\nCreate graph:\n";
     cin.clear();
@@ -34,11 +111,35 @@ void AlgorithmGraph::test() {
 
     // Test once algorithm at each time
     //algorithmGraph->testTopoSort(g);
+    //algorithmGraph->testTopoLevels(g);
+    //algorithmGraph->testSCC(g);
+    //algorithmGraph->benchmarkSCC();
+    //algorithmGraph->testBFS(g);
     //algorithmGraph->testDijkstra(g);
+    //algorithmGraph->testDeltaStepping(g);
+    //algorithmGraph->benchmarkDeltaStepping();
+    //algorithmGraph->testFloydWarshall(g);
+    //algorithmGraph->benchmarkFloydWarshall();
+    //algorithmGraph->testBellmanFord(g);
+    //algorithmGraph->testJohnson(g);
+    //algorithmGraph->testPageRank(g);
+    //algorithmGraph->benchmarkPageRank();
+    //algorithmGraph->testTriangles(g);
+    //algorithmGraph->benchmarkTriangles();
+    //algorithmGraph->testBetweenness(g);
+    //algorithmGraph->benchmarkBetweenness();
+    //algorithmGraph->benchmarkWorkspace();
+    //algorithmGraph->testYen(g);
     //algorithmGraph->testPrim(g);
+    //algorithmGraph->testKruskal(g);
+    //algorithmGraph->testBoruvka(g);
     //algorithmGraph->testHungarian(g);
+    //algorithmGraph->testHopcroftKarp(g);
     //algorithmGraph->testKM(g);
+    //algorithmGraph->testAssignment();
     //algorithmGraph->testEdmondKarp(g);
+    //algorithmGraph->testMaxFlow(g);
+    //algorithmGraph->testMinCostFlow(g);
 
     delete g;
 }
@@ -55,7 +156,7 @@ Graph* AlgorithmGraph::createGraphFromInput() {
     num_type n;
     cin >> n;
     initGlobals(n);
-    cout << "Choose storage type (0->list, 1->matrix): ";
+    cout << "Choose storage type (0->list, 1->matrix, 2->hash): ";
     int typeInt;
     cin >> typeInt;
     Graph *g = new Graph(n, static_cast<Graph::StorageType>(typeInt));
@@ -69,115 +170,2564 @@ Graph* AlgorithmGraph::createGraphFromInput() {
                 ++indegree[j];
             }
         }
-    }
-    cout << endl;
-    return g;
-}
+    }
+    cout << endl;
+    return g;
+}
+
+bool AlgorithmGraph::isAllVisit() {
+    bool res = true;
+    for (const auto &v : visit) {
+        if (!v) {
+            res = false;
+        }
+    }
+    return res;
+}
+
+AlgorithmGraph::num_type AlgorithmGraph::getMinNotVisit(const Graph *g) {
+    num_type n = -1;
+    weight_type min = INF;
+    for (auto i = 0; i < g->size(); ++i) {
+        if (!visit[i] && dist[i] < min) {
+            min = dist[i];
+            n = i;
+        }
+    }
+    return n;
+}
+
+bool AlgorithmGraph::topoSort(Graph *g, vector<num_type> &res) {
+    Workspace ws;
+    return topoSort(g, res, ws);
+}
+
+bool AlgorithmGraph::topoSort(const Graph *g, vector<num_type> &res, Workspace &ws) const {
+    num_type size = g->size();
+    ws.reset(size);
+    auto &adjNodes = ws.neighbours;
+    for (auto i = 0; i < size; ++i) {
+        g->getNeighbours(i, adjNodes);
+        for (const auto &adjN : adjNodes) {
+            ws.setCount(adjN, ws.getCount(adjN) + 1);
+        }
+    }
+    // The result works as the queue
+    res.clear();
+    for (auto i = 0; i < size; ++i) {
+        if (ws.getCount(i) == 0) {
+            res.push_back(i);
+        }
+    }
+    for (size_t head = 0; head < res.size(); ++head) {
+        g->getNeighbours(res[head], adjNodes);
+        for (const auto &adjN : adjNodes) {
+            auto c = ws.getCount(adjN) - 1;
+            ws.setCount(adjN, c);
+            if (c == 0) {
+                res.push_back(adjN);
+            }
+        }
+    }
+    return (num_type)res.size() == size;
+}
+
+void AlgorithmGraph::testTopoSort(Graph *g) {
+    cout << "Test topological sort:\n\n";
+    cin.clear();
+    vector<num_type> res;
+    if (topoSort(g, res)) {
+        cout << "Graph contains no cycle\n"
+            << "Sort result: ";
+        for (unsigned i = 0; i < res.size(); ++i) {
+            cout << res[i] << " ";
+        }
+        cout << endl;
+    } else {
+        cout << "Graph contains cycle\n"
+            << "Sort failed" << endl;
+    }
+}
+
+bool AlgorithmGraph::topoLevels(const CSRGraph &g, LevelResult &res, const unsigned threadNum) {
+    typedef CSRGraph::index_type index_type;
+    const num_type n = g.size();
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    vector<std::atomic<index_type>> indeg(n);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        indeg[v].store(0, std::memory_order_relaxed);
+    }, threads);
+    Parallel::forRange(0, g.edgeCount(), [&](unsigned long long j) {
+        indeg[tgts[j]].fetch_add(1, std::memory_order_relaxed);
+    }, threads, 4096);
+
+    res.order.clear();
+    res.offsets.assign(1, 0);
+    res.level.assign(n, NOT_NODE);
+    vector<vector<num_type>> local(threads);
+    auto gather = [&]() {  // Append local queues as the next level
+        for (unsigned t = 0; t < threads; ++t) {
+            res.order.insert(res.order.end(), local[t].begin(), local[t].end());
+            local[t].clear();
+        }
+        res.offsets.push_back(res.order.size());
+    };
+    // The threads are started once and stay for all the levels,
+    // thread 0 appends each level between two barriers
+    const num_type GRAIN = 64;
+    std::atomic<unsigned long long> next(0);
+    num_type depth = 0;
+    Parallel::Barrier barrier(threads);
+    auto expand = [&](const unsigned t, const unsigned long long lo, const unsigned long long hi) {
+        for (auto i = lo; i < hi; ++i) {
+            auto u = res.order[i];
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto v = tgts[j];
+                // The last in-edge to be removed releases the node
+                if (indeg[v].fetch_sub(1, std::memory_order_relaxed) == 1) {
+                    res.level[v] = depth + 1;
+                    local[t].push_back(v);
+                }
+            }
+        }
+    };
+    Parallel::run(threads, [&](unsigned t) {
+        Parallel::takeChunks(next, n, [&](unsigned long long lo, unsigned long long hi) {
+            for (auto v = lo; v < hi; ++v) {
+                if (indeg[v].load(std::memory_order_relaxed) == 0) {
+                    res.level[v] = 0;
+                    local[t].push_back(v);
+                }
+            }
+        });
+        barrier.wait();
+        if (t == 0) {
+            gather();
+        }
+        while (1) {
+            if (t == 0) {
+                // Levels of one chunk are expanded by thread 0 alone,
+                // the others wait instead of meeting for each level
+                while (res.offsets[depth + 1] > res.offsets[depth]
+                       && res.offsets[depth + 1] - res.offsets[depth] <= GRAIN) {
+                    expand(0, res.offsets[depth], res.offsets[depth + 1]);
+                    gather();
+                    ++depth;
+                }
+                next.store(res.offsets[depth]);
+            }
+            barrier.wait();
+            if (res.offsets[depth + 1] == res.offsets[depth]) {
+                break;
+            }
+            Parallel::takeChunks(next, res.offsets[depth + 1], [&](unsigned long long lo, unsigned long long hi) {
+                expand(t, lo, hi);
+            }, GRAIN);
+            barrier.wait();
+            if (t == 0) {
+                gather();
+                ++depth;
+            }
+        }
+    });
+    res.offsets.pop_back();  // The last level is empty
+    return (num_type)res.order.size() == n;
+}
+
+bool AlgorithmGraph::topoLevels(const Graph *g, LevelResult &res, const unsigned threadNum) {
+    return topoLevels(CSRGraph(g), res, threadNum);
+}
+
+void AlgorithmGraph::testTopoLevels(Graph *g) {
+    cout << "Test topological levels:\n\n";
+    cin.clear();
+    LevelResult res;
+    bool acyclic = topoLevels(g, res);
+    cout << (acyclic ? "Graph contains no cycle" : "Graph contains cycle") << endl;
+    for (size_t i = 0; i + 1 < res.offsets.size(); ++i) {
+        cout << "Level " << i << ":";
+        for (auto j = res.offsets[i]; j < res.offsets[i + 1]; ++j) {
+            cout << " " << res.order[j];
+        }
+        cout << endl;
+    }
+    if (!acyclic) {
+        cout << "Not sorted:";
+        for (auto v = 0; v < g->size(); ++v) {
+            if (res.level[v] == NOT_NODE) {
+                cout << " " << v;
+            }
+        }
+        cout << endl;
+    }
+}
+
+namespace {
+
+typedef CSRGraph::index_type index_type;
+typedef CSRGraph::offset_type offset_type;
+
+const index_type UNVISITED = std::numeric_limits<index_type>::max();
+
+/*
+Tarjan search from a root over the nodes accepted by active(v),
+with explicit stacks instead of recursion. Each finished component
+gets the id newId(root). Searches on disjoint node sets may run at
+the same time, as they touch different entries of the arrays.
+
+@param index the visit order of each node, UNVISITED if not visited
+@param low the smallest visit order reachable, valid if visited
+@param comp the component id of each node, -1 if not finished
+@param counter the next visit order
+@param calls the call stack of (node, next edge), empty
+@param stack the nodes of unfinished components, empty
+*/
+template <typename Active, typename NewId>
+void tarjanFrom(const CSRGraph &g, const index_type root, Active active, NewId newId,
+                vector<index_type> &index, vector<index_type> &low,
+                vector<AlgorithmGraph::num_type> &comp, index_type &counter,
+                vector<std::pair<index_type, offset_type>> &calls,
+                vector<index_type> &stack) {
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    auto visit = [&](const index_type v) {
+        index[v] = low[v] = counter++;
+        stack.push_back(v);
+        calls.push_back(std::make_pair(v, offs[v]));
+    };
+    visit(root);
+    while (!calls.empty()) {
+        auto v = calls.back().first;
+        auto j = calls.back().second;
+        if (j < offs[v + 1]) {
+            calls.back().second = j + 1;
+            auto w = tgts[j];
+            if (!active(w)) {
+                continue;
+            }
+            if (index[w] == UNVISITED) {
+                visit(w);
+            } else if (comp[w] == -1) {
+                low[v] = std::min(low[v], index[w]);  // w is on the stack
+            }
+            continue;
+        }
+        calls.pop_back();
+        if (low[v] == index[v]) {
+            // v is the root of a component
+            auto id = newId(v);
+            index_type w;
+            do {
+                w = stack.back();
+                stack.pop_back();
+                comp[w] = id;
+            } while (w != v);
+        }
+        if (!calls.empty()) {
+            auto u = calls.back().first;
+            low[u] = std::min(low[u], low[v]);
+        }
+    }
+}
+
+}
+
+AlgorithmGraph::SCCResult AlgorithmGraph::tarjan(const CSRGraph &g) {
+    const num_type n = g.size();
+    SCCResult res;
+    res.component.assign(n, NOT_NODE);
+    vector<index_type> index(n, UNVISITED), low(n);
+    vector<std::pair<index_type, offset_type>> calls;
+    vector<index_type> stack;
+    index_type counter = 0;
+    num_type count = 0;
+    for (auto v = 0; v < n; ++v) {
+        if (index[v] == UNVISITED) {
+            tarjanFrom(g, (index_type)v, [](const index_type) { return true; },
+                       [&](const index_type) { return count++; },
+                       index, low, res.component, counter, calls, stack);
+        }
+    }
+    res.count = count;
+    return res;
+}
+
+AlgorithmGraph::SCCResult AlgorithmGraph::tarjan(const Graph *g) {
+    return tarjan(CSRGraph(g));
+}
+
+AlgorithmGraph::SCCResult AlgorithmGraph::forwardBackward(const CSRGraph &out, const CSRGraph &in,
+                                                          const unsigned threadNum) {
+    typedef unsigned char flag_type;
+    const num_type n = out.size();
+    if (in.size() != n) {
+        throw std::range_error("AlgorithmGraph.forwardBackward(): graph sizes do not match");
+    }
+    // Search marks of each node
+    const flag_type FORWARD = 1, BACKWARD = 2, TRIMMED = 4;
+    // Sets no larger than this are left to tarjan searches
+    const size_t SMALL_SET = 4096;
+    const unsigned threads = Parallel::threadCount(threadNum);
+
+    SCCResult res;
+    res.component.assign(n, NOT_NODE);
+    // Nodes of the same set share a color, which is the number of
+    // one node of the set. Finished nodes have the color DONE.
+    const index_type DONE = UNVISITED;
+    vector<index_type> color(n, 0);
+    vector<std::atomic<flag_type>> flags(n);
+    vector<std::atomic<index_type>> inDeg(n), outDeg(n);
+    vector<index_type> frontier;
+    vector<vector<index_type>> local(threads);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        flags[v].store(0, std::memory_order_relaxed);
+        inDeg[v].store((index_type)in.degree(v), std::memory_order_relaxed);
+        outDeg[v].store((index_type)out.degree(v), std::memory_order_relaxed);
+    }, threads);
+    auto gather = [&]() {  // Collect local queues into the frontier
+        frontier.clear();
+        for (unsigned t = 0; t < threads; ++t) {
+            frontier.insert(frontier.end(), local[t].begin(), local[t].end());
+            local[t].clear();
+        }
+    };
+    // Expand the frontier level by level until it is empty, calling
+    // visit(t, u) on thread t for each node u of a level. The threads
+    // are started once, thread 0 collects each level between two barriers
+    const size_t LEVEL_GRAIN = 64;
+    auto levels = [&](const std::function<void(unsigned, index_type)> &visit) {
+        std::atomic<unsigned long long> next(0);
+        Parallel::Barrier barrier(threads);
+        Parallel::run(threads, [&](unsigned t) {
+            while (1) {
+                if (t == 0) {
+                    // Levels of one chunk are expanded by thread 0 alone,
+                    // the others wait instead of meeting for each level
+                    while (!frontier.empty() && frontier.size() <= LEVEL_GRAIN) {
+                        for (const auto &u : frontier) {
+                            visit(0, u);
+                        }
+                        gather();
+                    }
+                    next.store(0);
+                }
+                barrier.wait();
+                if (frontier.empty()) {
+                    break;
+                }
+                Parallel::takeChunks(next, frontier.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    for (auto i = lo; i < hi; ++i) {
+                        visit(t, frontier[i]);
+                    }
+                }, LEVEL_GRAIN);
+                barrier.wait();
+                if (t == 0) {
+                    gather();
+                }
+            }
+        });
+    };
+    auto trim = [&](const index_type v) {  // Make v a single component
+        if (flags[v].fetch_or(TRIMMED, std::memory_order_relaxed) & TRIMMED) {
+            return false;
+        }
+        color[v] = DONE;
+        res.component[v] = v;
+        return true;
+    };
+
+    // Trim level by level: removing a node may expose its neighbours
+    Parallel::forChunks(0, n, [&](unsigned t, unsigned long long lo, unsigned long long hi) {
+        for (auto v = lo; v < hi; ++v) {
+            if ((out.degree(v) == 0 || in.degree(v) == 0) && trim((index_type)v)) {
+                local[t].push_back((index_type)v);
+            }
+        }
+    }, threads);
+    gather();
+    levels([&](unsigned t, index_type u) {
+        for (auto j = out.offsets()[u]; j < out.offsets()[u + 1]; ++j) {
+            auto w = out.targets()[j];
+            if (inDeg[w].fetch_sub(1, std::memory_order_relaxed) == 1 && trim(w)) {
+                local[t].push_back(w);
+            }
+        }
+        for (auto j = in.offsets()[u]; j < in.offsets()[u + 1]; ++j) {
+            auto w = in.targets()[j];
+            if (outDeg[w].fetch_sub(1, std::memory_order_relaxed) == 1 && trim(w)) {
+                local[t].push_back(w);
+            }
+        }
+    });
+
+    // Nodes reached from the pivot inside its set get the mark
+    auto reach = [&](const CSRGraph &g, const index_type pivot, const flag_type mark) {
+        const auto &offs = g.offsets();
+        const auto &tgts = g.targets();
+        const auto c = color[pivot];
+        flags[pivot].fetch_or(mark, std::memory_order_relaxed);
+        frontier.assign(1, pivot);
+        levels([&](unsigned t, index_type u) {
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto w = tgts[j];
+                if (color[w] == c && !(flags[w].load(std::memory_order_relaxed) & mark)
+                    && !(flags[w].fetch_or(mark, std::memory_order_relaxed) & mark)) {
+                    local[t].push_back(w);
+                }
+            }
+        });
+    };
+
+    vector<vector<index_type>> large, small;
+    vector<index_type> rest;
+    for (auto v = 0; v < n; ++v) {
+        if (color[v] != DONE) {
+            rest.push_back((index_type)v);
+        }
+    }
+    if (!rest.empty()) {
+        auto &to = rest.size() > SMALL_SET ? large : small;
+        to.push_back(vector<index_type>());
+        to.back().swap(rest);
+    }
+    while (!large.empty()) {
+        vector<index_type> nodes;
+        nodes.swap(large.back());
+        large.pop_back();
+        // The pivot with most paths through it likely lies in a large component
+        auto pivot = nodes[0];
+        for (const auto &v : nodes) {
+            if (out.degree(v) * in.degree(v) > out.degree(pivot) * in.degree(pivot)) {
+                pivot = v;
+            }
+        }
+        reach(out, pivot, FORWARD);
+        reach(in, pivot, BACKWARD);
+        vector<index_type> parts[3];  // Forward only, backward only, neither
+        size_t sccSize = 0;
+        for (const auto &v : nodes) {
+            auto f = flags[v].load(std::memory_order_relaxed);
+            flags[v].store(0, std::memory_order_relaxed);
+            if ((f & FORWARD) && (f & BACKWARD)) {
+                color[v] = DONE;
+                res.component[v] = pivot;
+                ++sccSize;
+            } else {
+                parts[(f & FORWARD) ? 0 : ((f & BACKWARD) ? 1 : 2)].push_back(v);
+            }
+        }
+        // A small pivot component means the splits peel off too little
+        bool split = sccSize * 64 >= nodes.size();
+        for (auto &part : parts) {
+            if (part.empty()) {
+                continue;
+            }
+            for (const auto &v : part) {
+                color[v] = part[0];
+            }
+            auto &to = split && part.size() > SMALL_SET ? large : small;
+            to.push_back(vector<index_type>());
+            to.back().swap(part);
+        }
+    }
+
+    // Finish the small sets with tarjan searches, one set at a time per thread
+    vector<index_type> index(n, UNVISITED), low(n);
+    std::atomic<size_t> next(0);
+    Parallel::run(threads, [&](unsigned) {
+        vector<std::pair<index_type, offset_type>> calls;
+        vector<index_type> stack;
+        index_type counter = 0;
+        while (1) {
+            auto i = next.fetch_add(1);
+            if (i >= small.size()) {
+                break;
+            }
+            const auto c = color[small[i][0]];
+            for (const auto &v : small[i]) {
+                if (index[v] == UNVISITED) {
+                    tarjanFrom(out, v, [&](const index_type w) { return color[w] == c; },
+                               [](const index_type root) { return (num_type)root; },
+                               index, low, res.component, counter, calls, stack);
+                }
+            }
+        }
+    });
+
+    // Each component is named by one of its nodes, number them from 0
+    const unsigned long long GRAIN = 1 << 16;
+    const unsigned long long chunks = (n + GRAIN - 1) / GRAIN;
+    vector<index_type> first(chunks + 1, 0);
+    auto &id = index;
+    Parallel::forRange(0, chunks, [&](unsigned long long c) {
+        index_type cnt = 0;
+        for (auto v = c * GRAIN; v < std::min<unsigned long long>(n, (c + 1) * GRAIN); ++v) {
+            if (res.component[v] == (num_type)v) {
+                id[v] = cnt++;  // Number inside the chunk
+            }
+        }
+        first[c + 1] = cnt;
+    }, threads, 1);
+    for (unsigned long long c = 0; c < chunks; ++c) {
+        first[c + 1] += first[c];
+    }
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        auto root = res.component[v];
+        res.component[v] = (num_type)first[root / GRAIN] + id[root];
+    }, threads);
+    res.count = first[chunks];
+    return res;
+}
+
+Graph* AlgorithmGraph::condensation(const CSRGraph &g, const SCCResult &scc) {
+    const num_type n = g.size(), k = scc.count;
+    if ((num_type)scc.component.size() != n) {
+        throw std::range_error("AlgorithmGraph.condensation(): components do not match the graph");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    // Group the nodes by component (counting sort)
+    vector<offset_type> start(k + 1, 0);
+    for (const auto &c : scc.component) {
+        ++start[c + 1];
+    }
+    for (auto c = 0; c < k; ++c) {
+        start[c + 1] += start[c];
+    }
+    vector<index_type> members(n);
+    {
+        auto pos = start;
+        for (auto v = 0; v < n; ++v) {
+            members[pos[scc.component[v]]++] = (index_type)v;
+        }
+    }
+    Graph *res = new Graph(k);
+    vector<num_type> seen(k, NOT_NODE), adjComps;
+    vector<weight_type> minW(k);
+    for (auto c = 0; c < k; ++c) {
+        adjComps.clear();
+        for (auto i = start[c]; i < start[c + 1]; ++i) {
+            auto u = members[i];
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto d = scc.component[tgts[j]];
+                if (d == c) {
+                    continue;
+                }
+                if (seen[d] != c) {
+                    seen[d] = c;
+                    minW[d] = wts[j];
+                    adjComps.push_back(d);
+                } else {
+                    minW[d] = std::min(minW[d], wts[j]);
+                }
+            }
+        }
+        for (const auto &d : adjComps) {
+            res->addEdge(c, d, minW[d]);
+        }
+    }
+    return res;
+}
+
+void AlgorithmGraph::testSCC(Graph *g) {
+    cout << "Test strongly connected components:\n\n";
+    cin.clear();
+    CSRGraph out(g);
+    auto res = tarjan(out);
+    cout << res.count << " component(s):" << endl;
+    for (auto c = 0; c < res.count; ++c) {
+        cout << "Component " << c << ":";
+        for (auto v = 0; v < g->size(); ++v) {
+            if (res.component[v] == c) {
+                cout << " " << v;
+            }
+        }
+        cout << endl;
+    }
+    auto other = forwardBackward(out, out.transpose());
+    cout << "Same components as forward-backward: "
+        << (isSamePartition(res, other) ? "yes" : "no") << endl;
+    Graph *dag = condensation(out, res);
+    vector<num_type> order;
+    cout << "Condensation is a DAG: " << (topoSort(dag, order) ? "yes" : "no") << endl;
+    dag->print();
+    delete dag;
+}
+
+bool AlgorithmGraph::isSamePartition(const SCCResult &a, const SCCResult &b) {
+    if (a.count != b.count || a.component.size() != b.component.size()) {
+        return false;
+    }
+    vector<num_type> map(a.count, NOT_NODE);
+    for (size_t v = 0; v < a.component.size(); ++v) {
+        auto &m = map[a.component[v]];
+        if (m == NOT_NODE) {
+            m = b.component[v];
+        } else if (m != b.component[v]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AlgorithmGraph::benchmarkSCC() {
+    cout << "Benchmark strongly connected components:\n\n";
+    cin.clear();
+    unsigned scale, maxThreads;
+    cout << "Input R-MAT scale and max threads number: ";
+    cin >> scale >> maxThreads;
+    cout << endl;
+    const num_type n = (num_type)1 << scale;
+    for (int kind = 0; kind < 2; ++kind) {
+        vector<Graph::Edge> edges;
+        if (kind == 0) {
+            GraphGenerator::rmat(scale, 8, 1, 100, false, edges);
+            printf("Power-law graph (R-MAT, scale %u):\n", scale);
+        } else {
+            for (auto v = 0; v < n; ++v) {
+                edges.push_back(Graph::Edge(v, (v + 1) % n, 1));
+            }
+            printf("Ring of %ld nodes:\n", n);
+        }
+        CSRGraph out(n, edges);
+        edges.clear();
+        auto in = out.transpose();
+        Timer timer;
+        auto expected = tarjan(out);
+        double base = timer.elapse();
+        printf("%ld nodes, %llu edges, %ld component(s)\n", n, out.edgeCount(), expected.count);
+        printf("      tarjan: %10.2lf ms\n", base);
+        benchmarkThreads("", maxThreads, base, [&](unsigned threads) {
+            return isSamePartition(forwardBackward(out, in, threads), expected);
+        });
+        cout << endl;
+    }
+}
+
+AlgorithmGraph::BFSResult AlgorithmGraph::bfs(const CSRGraph &out, const CSRGraph &in,
+                                               const num_type &src, const unsigned threadNum) {
+    typedef CSRGraph::index_type index_type;
+    typedef CSRGraph::offset_type offset_type;
+    typedef unsigned long long word;
+    const num_type n = out.size();
+    if (src < 0 || src >= n) {
+        throw std::range_error("AlgorithmGraph.bfs(): start node is not valid");
+    }
+    const offset_type ALPHA = 14, BETA = 24;
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &offs = out.offsets();
+    const auto &tgts = out.targets();
+    const auto &inOffs = in.offsets();
+    const auto &inTgts = in.targets();
+
+    BFSResult res;
+    res.level.assign(n, NOT_NODE);
+    vector<std::atomic<num_type>> parent(n);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        parent[v].store(NOT_NODE, std::memory_order_relaxed);
+    }, threads);
+    parent[src].store(src);  // Mark visited
+    res.level[src] = 0;
+
+    // Frontier as a queue (top-down) or as a bitmap (bottom-up)
+    vector<index_type> queue(1, (index_type)src);
+    vector<std::atomic<word>> front((n + 63) / 64), next((n + 63) / 64);
+    vector<vector<index_type>> local(threads);
+    vector<offset_type> localScout(threads);
+    auto gather = [&]() {  // Collect local queues into the frontier queue
+        queue.clear();
+        offset_type scout = 0;
+        for (unsigned t = 0; t < threads; ++t) {
+            queue.insert(queue.end(), local[t].begin(), local[t].end());
+            local[t].clear();
+            scout += localScout[t];
+            localScout[t] = 0;
+        }
+        return scout;
+    };
+
+    offset_type edgesToCheck = out.edgeCount();         // mu
+    offset_type scout = out.degree(src);                // mf
+    offset_type frontierSize = 1, lastFrontierSize = 0;
+    bool bottomUp = false, toBottomUp = false, toTopDown = false;
+    num_type depth = 0;
+    std::atomic<offset_type> awake(0);
+    std::atomic<unsigned long long> step[4];  // Chunk counters of the steps in a level
+    // Choose the direction of the next level, run by thread 0 only
+    auto decide = [&]() {
+        toBottomUp = !bottomUp && scout > edgesToCheck / ALPHA;
+        toTopDown = bottomUp && frontierSize < (offset_type)n / BETA && frontierSize < lastFrontierSize;
+        bottomUp = (bottomUp || toBottomUp) && !toTopDown;
+        lastFrontierSize = frontierSize;
+        for (auto &s : step) {
+            s.store(0);
+        }
+        awake.store(0);
+    };
+
+    // Each frontier node claims its unvisited out-neighbours
+    auto topDown = [&](const unsigned t, const unsigned long long lo, const unsigned long long hi) {
+        for (auto i = lo; i < hi; ++i) {
+            auto u = queue[i];
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto v = tgts[j];
+                num_type expected = NOT_NODE;
+                if (parent[v].load(std::memory_order_relaxed) == NOT_NODE
+                    && parent[v].compare_exchange_strong(expected, u)) {
+                    res.level[v] = depth + 1;
+                    local[t].push_back(v);
+                    localScout[t] += out.degree(v);
+                }
+            }
+        }
+    };
+    auto finishTopDown = [&]() {  // Run by thread 0 only
+        edgesToCheck -= std::min(edgesToCheck, scout);
+        scout = gather();
+        frontierSize = queue.size();
+    };
+
+    // The threads are started once and stay for all the levels, thread 0
+    // switches the direction and collects the frontier between two barriers
+    const unsigned long long GRAIN = 64;
+    Parallel::Barrier barrier(threads);
+    decide();
+    Parallel::run(threads, [&](unsigned t) {
+        while (1) {
+            if (t == 0) {
+                // Top-down levels of one chunk are expanded by thread 0
+                // alone, the others wait instead of meeting for each level
+                while (frontierSize > 0 && !bottomUp && !toTopDown && queue.size() <= GRAIN) {
+                    topDown(0, 0, queue.size());
+                    finishTopDown();
+                    ++depth;
+                    decide();
+                }
+            }
+            barrier.wait();
+            if (frontierSize == 0) {
+                break;
+            }
+            if (toBottomUp) {
+                // Convert the queue to a bitmap
+                Parallel::takeChunks(step[0], front.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    for (auto i = lo; i < hi; ++i) {
+                        front[i].store(0, std::memory_order_relaxed);
+                    }
+                });
+                barrier.wait();
+                Parallel::takeChunks(step[1], queue.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    for (auto i = lo; i < hi; ++i) {
+                        front[queue[i] / 64].fetch_or(word(1) << (queue[i] % 64), std::memory_order_relaxed);
+                    }
+                });
+                barrier.wait();
+            } else if (toTopDown) {
+                // Convert the bitmap to a queue
+                Parallel::takeChunks(step[0], front.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    for (auto i = lo; i < hi; ++i) {
+                        for (word w = front[i].load(std::memory_order_relaxed); w; w &= w - 1) {
+                            auto v = (index_type)(i * 64 + __builtin_ctzll(w));
+                            local[t].push_back(v);
+                            localScout[t] += out.degree(v);
+                        }
+                    }
+                }, 64);
+                barrier.wait();
+                if (t == 0) {
+                    scout = gather();
+                }
+                barrier.wait();
+            }
+            if (bottomUp) {
+                Parallel::takeChunks(step[2], next.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    for (auto i = lo; i < hi; ++i) {
+                        next[i].store(0, std::memory_order_relaxed);
+                    }
+                });
+                barrier.wait();
+                Parallel::takeChunks(step[3], n, [&](unsigned long long lo, unsigned long long hi) {
+                    offset_type cnt = 0;
+                    for (auto v = lo; v < hi; ++v) {
+                        if (parent[v].load(std::memory_order_relaxed) != NOT_NODE) {
+                            continue;
+                        }
+                        for (auto j = inOffs[v]; j < inOffs[v + 1]; ++j) {
+                            auto u = inTgts[j];
+                            if (front[u / 64].load(std::memory_order_relaxed) & (word(1) << (u % 64))) {
+                                parent[v].store(u, std::memory_order_relaxed);
+                                res.level[v] = depth + 1;
+                                next[v / 64].fetch_or(word(1) << (v % 64), std::memory_order_relaxed);
+                                ++cnt;
+                                break;
+                            }
+                        }
+                    }
+                    awake += cnt;
+                });
+            } else {
+                Parallel::takeChunks(step[2], queue.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    topDown(t, lo, hi);
+                }, GRAIN);
+            }
+            barrier.wait();
+            if (t == 0) {
+                if (bottomUp) {
+                    front.swap(next);
+                    frontierSize = awake.load();
+                } else {
+                    finishTopDown();
+                }
+                ++depth;
+                decide();
+            }
+        }
+    });
+
+    res.parent.resize(n);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        res.parent[v] = parent[v].load(std::memory_order_relaxed);
+    }, threads);
+    res.parent[src] = NOT_NODE;
+    return res;
+}
+
+AlgorithmGraph::BFSResult AlgorithmGraph::bfs(const Graph *g, const num_type &src,
+                                               const unsigned threadNum) {
+    CSRGraph out(g);
+    return bfs(out, out.transpose(), src, threadNum);
+}
+
+void AlgorithmGraph::testBFS(Graph *g) {
+    cout << "Test BFS:\n\n";
+    cin.clear();
+    num_type src;
+    cout << "Input start vertex: ";
+    cin >> src;
+    auto res = bfs(g, src);
+    for (auto i = 0; i < g->size(); ++i) {
+        cout << "From node " << src << " to " << i;
+        if (res.level[i] == NOT_NODE) {
+            cout << ": unreachable" << endl;
+            continue;
+        }
+        cout << " (hops: " << res.level[i] << "): ";
+        printPathTo(i, res.parent);
+        cout << endl;
+    }
+}
+
+void AlgorithmGraph::dijkstra(Graph *g, const num_type &src) {
+    dist[src] = 0;
+    while (!isAllVisit()) {
+        auto n = getMinNotVisit(g);
+        visit[n] = true;
+        vector<num_type> adjNodes;
+        g->getNeighbours(n, adjNodes);
+        for (const auto &adjN : adjNodes) {
+            auto w = g->getWeight(n, adjN);
+            if (!visit[adjN] && dist[n] + w < dist[adjN]) {
+                dist[adjN] = dist[n] + w;
+                prev[adjN] = n;
+            }
+        }
+    }
+}
+
+void AlgorithmGraph::dijkstra(const Graph *g, const num_type &src, Workspace &ws) const {
+    typedef std::pair<weight_type, num_type> heap_node;
+    const num_type n = g->size();
+    if (src < 0 || src >= n) {
+        throw std::range_error("AlgorithmGraph.dijkstra(): start node is not valid");
+    }
+    ws.reset(n);
+    auto &q = ws.heap;
+    auto &adjNodes = ws.neighbours;
+    std::greater<heap_node> cmp;
+    q.clear();
+    ws.setDist(src, 0);
+    q.push_back(heap_node(0, src));
+    while (!q.empty()) {
+        auto u = q.front().second;
+        std::pop_heap(q.begin(), q.end(), cmp);
+        q.pop_back();
+        if (ws.isVisited(u)) {
+            continue;  // Outdated heap node
+        }
+        ws.setVisited(u);
+        auto du = ws.getDist(u);
+        g->getNeighbours(u, adjNodes);
+        for (const auto &v : adjNodes) {
+            auto d = du + g->getWeight(u, v);
+            if (d < ws.getDist(v)) {
+                ws.setDist(v, d);
+                ws.setPrev(v, u);
+                q.push_back(heap_node(d, v));
+                std::push_heap(q.begin(), q.end(), cmp);
+            }
+        }
+    }
+}
+
+void AlgorithmGraph::printPathTo(const num_type &des, const vector<num_type> &prev_) {
+    auto tmp = des;
+    if (prev_[tmp] != NOT_NODE) {
+        printPathTo(prev_[tmp], prev_);
+        cout << " -> ";
+    }
+    cout << tmp;
+}
+
+void AlgorithmGraph::testDijkstra(Graph *g) {
+    cout << "Test dijkstra:\n\n";
+    cin.clear();
+    num_type src;
+    cout << "Input start vertex: ";
+    cin >> src;
+    dijkstra(g, src);
+    cout << "The shortest path:" << endl;
+    for (auto i = 0; i < g->size(); ++i) {
+        cout << "From node " << src << " to " << i
+            << " (length: " << dist[i] << "): ";
+        printPathTo(i, prev);
+        cout << endl;
+    }
+}
+
+AlgorithmGraph::PathResult AlgorithmGraph::dijkstra(const CSRGraph &g, const num_type &src) {
+    typedef std::pair<weight_type, CSRGraph::index_type> heap_node;
+    const num_type n = g.size();
+    if (src < 0 || src >= n) {
+        throw std::range_error("AlgorithmGraph.dijkstra(): start node is not valid");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    PathResult res;
+    res.dist.assign(n, INF);
+    res.prev.assign(n, NOT_NODE);
+    vector<bool> done(n, false);
+    priority_queue<heap_node, vector<heap_node>, std::greater<heap_node>> q;
+    res.dist[src] = 0;
+    q.push(heap_node(0, (CSRGraph::index_type)src));
+    while (!q.empty()) {
+        auto u = q.top().second;
+        q.pop();
+        if (done[u]) {
+            continue;  // Outdated heap node
+        }
+        done[u] = true;
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            auto v = tgts[j];
+            auto d = res.dist[u] + wts[j];
+            if (d < res.dist[v]) {
+                res.dist[v] = d;
+                res.prev[v] = u;
+                q.push(heap_node(d, v));
+            }
+        }
+    }
+    return res;
+}
+
+void AlgorithmGraph::dijkstra(const CSRGraph &g, const num_type &src, Workspace &ws,
+                              const num_type &des) const {
+    typedef std::pair<weight_type, num_type> heap_node;
+    const num_type n = g.size();
+    if (src < 0 || src >= n) {
+        throw std::range_error("AlgorithmGraph.dijkstra(): start node is not valid");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    ws.reset(n);
+    auto &q = ws.heap;
+    std::greater<heap_node> cmp;
+    const bool masked = ws.hasMasks();
+    q.clear();
+    ws.setDist(src, 0);
+    q.push_back(heap_node(0, src));
+    while (!q.empty()) {
+        auto u = q.front().second;
+        std::pop_heap(q.begin(), q.end(), cmp);
+        q.pop_back();
+        if (ws.isVisited(u)) {
+            continue;  // Outdated heap node
+        }
+        ws.setVisited(u);
+        if (u == des) {
+            break;
+        }
+        auto du = ws.getDist(u);
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            num_type v = tgts[j];
+            if (masked && (ws.isEdgeMasked(j) || ws.isNodeMasked(v))) {
+                continue;
+            }
+            auto d = du + wts[j];
+            if (d < ws.getDist(v)) {
+                ws.setDist(v, d);
+                ws.setPrev(v, u);
+                q.push_back(heap_node(d, v));
+                std::push_heap(q.begin(), q.end(), cmp);
+            }
+        }
+    }
+}
+
+void AlgorithmGraph::benchmarkWorkspace() {
+    cout << "Benchmark workspace:\n\n";
+    cin.clear();
+    num_type side, queries;
+    unsigned maxThreads;
+    cout << "Input grid side length, query number and max threads number: ";
+    cin >> side >> queries >> maxThreads;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::grid(side, side, 1, 100, edges);
+    CSRGraph csr(side * side, edges);
+    edges.clear();
+    // Local queries touch few nodes, so clearing O(n) per query dominates
+    auto random = Random::getInstance();
+    auto coord = [&](const num_type c) {
+        num_type x = c + (num_type)random->randInt(0, 20) - 10;
+        return x < 0 ? 0 : (x >= side ? side - 1 : x);
+    };
+    vector<std::pair<num_type, num_type>> pairs;
+    for (auto i = 0; i < queries; ++i) {
+        auto r = (num_type)random->randInt(0, side - 1), c = (num_type)random->randInt(0, side - 1);
+        pairs.push_back(std::make_pair(r * side + c, coord(r) * side + coord(c)));
+    }
+    printf("%ld nodes, %llu edges, %ld queries\n", csr.size(), csr.edgeCount(), queries);
+
+    vector<weight_type> expected(queries);
+    Timer timer;
+    for (auto i = 0; i < queries; ++i) {
+        Workspace ws;
+        dijkstra(csr, pairs[i].first, ws, pairs[i].second);
+        expected[i] = ws.getDist(pairs[i].second);
+    }
+    double base = timer.elapse();
+    printf("  new workspace per query: %10.2lf ms\n", base);
+
+    vector<weight_type> res(queries);
+    benchmarkThreads("  reused, ", maxThreads, base, [&](unsigned threads) {
+        std::atomic<num_type> next(0);
+        Parallel::run(threads, [&](unsigned) {
+            Workspace ws;
+            while (1) {
+                auto i = next.fetch_add(1);
+                if (i >= queries) {
+                    break;
+                }
+                dijkstra(csr, pairs[i].first, ws, pairs[i].second);
+                res[i] = ws.getDist(pairs[i].second);
+            }
+        });
+        return res == expected;
+    });
+    cout << endl;
+}
+
+void AlgorithmGraph::yen(const CSRGraph &g, const num_type &src, const num_type &des,
+                         const num_type k, vector<Path> &res, Workspace &ws) const {
+    yenSearch(g, nullptr, src, des, k, res, ws);
+}
+
+void AlgorithmGraph::lazyYen(const CSRGraph &out, const CSRGraph &in, const num_type &src,
+                             const num_type &des, const num_type k, vector<Path> &res,
+                             Workspace &ws) const {
+    if (in.size() != out.size()) {
+        throw std::range_error("AlgorithmGraph.lazyYen(): graph sizes do not match");
+    }
+    yenSearch(out, &in, src, des, k, res, ws);
+}
+
+void AlgorithmGraph::yenSearch(const CSRGraph &g, const CSRGraph *in, const num_type &src,
+                               const num_type &des, const num_type k, vector<Path> &res,
+                               Workspace &ws) const {
+    typedef CSRGraph::offset_type offset_type;
+    // A path found, or a spur search not run yet
+    struct Candidate {
+        weight_type key;         // Length of the path, or a lower bound of it
+        bool exact;              // True for a path found
+        size_t index;            // Index in the found paths, or of the path to deviate from
+        size_t spur;             // Index of the spur node in the path
+        weight_type rootLength;  // Length of the path up to the spur node
+
+        bool operator>(const Candidate &c) const {
+            // Found paths go before spur searches of the same bound
+            return key > c.key || (key == c.key && !exact && c.exact);
+        }
+    };
+    const num_type n = g.size();
+    if (src < 0 || src >= n || des < 0 || des >= n) {
+        throw std::range_error("AlgorithmGraph.yen(): node is not valid");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    res.clear();
+    ws.clearMasks();
+    if (k <= 0) {
+        return;
+    }
+    dijkstra(g, src, ws, des);
+    if (!ws.isVisited(des)) {
+        return;  // Unreachable
+    }
+    // Append the path found by the last search to the beginning of a path
+    auto appendPath = [&](Path &p) {
+        auto first = p.nodes.size();
+        for (auto v = des; v != NOT_NODE; v = ws.getPrev(v)) {
+            p.nodes.push_back(v);
+        }
+        std::reverse(p.nodes.begin() + first, p.nodes.end());
+        p.length += ws.getDist(des);
+    };
+    res.push_back(Path());
+    appendPath(res[0]);
+
+    // Distances to des, the nodes farther than src are bounded by its distance
+    vector<std::pair<num_type, weight_type>> toDes;
+    weight_type radius = 0;
+    if (in) {
+        dijkstra(*in, des, ws, src);
+        for (const auto &v : ws.touched()) {
+            if (ws.isVisited(v)) {
+                toDes.push_back(std::make_pair(v, ws.getDist(v)));
+                radius = std::max(radius, ws.getDist(v));
+            }
+        }
+        std::sort(toDes.begin(), toDes.end());
+    }
+    auto lowerBound = [&](const num_type v) {
+        auto it = std::lower_bound(toDes.begin(), toDes.end(), std::make_pair(v, (weight_type)0));
+        return it != toDes.end() && it->first == v ? it->second : radius;
+    };
+    auto edgeWeight = [&](const num_type u, const num_type v) {
+        weight_type w = INF;
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            if ((num_type)tgts[j] == v) {
+                w = std::min(w, wts[j]);
+            }
+        }
+        return w;
+    };
+    // Mask the nodes before node j of path i, and the next edges of
+    // the paths found with the same beginning
+    auto maskSpur = [&](const size_t i, const size_t j) {
+        const auto &base = res[i].nodes;
+        ws.clearMasks();
+        for (const auto &other : res) {
+            if (other.nodes.size() > j + 1
+                && std::equal(base.begin(), base.begin() + j + 1, other.nodes.begin())) {
+                auto u = other.nodes[j], v = other.nodes[j + 1];
+                for (offset_type e = offs[u]; e < offs[u + 1]; ++e) {
+                    if ((num_type)tgts[e] == v) {
+                        ws.maskEdge(e);
+                    }
+                }
+            }
+        }
+        for (size_t t = 0; t < j; ++t) {
+            ws.maskNode(base[t]);  // Keep the path simple
+        }
+    };
+    // A path deviating from path i at node u has at least this length
+    // after the beginning, more paths found only make it longer
+    auto spurBound = [&](const size_t i, const size_t j) {
+        maskSpur(i, j);
+        auto u = res[i].nodes[j];
+        weight_type bound = INF;
+        for (offset_type e = offs[u]; e < offs[u + 1]; ++e) {
+            if (!ws.isEdgeMasked(e) && !ws.isNodeMasked(tgts[e])) {
+                bound = std::min(bound, wts[e] + lowerBound(tgts[e]));
+            }
+        }
+        return bound;
+    };
+    // Shortest path deviating from path i at its node j, into p
+    auto spurSearch = [&](const size_t i, const size_t j, const weight_type rootLength, Path &p) {
+        const auto &base = res[i].nodes;
+        maskSpur(i, j);
+        dijkstra(g, base[j], ws, des);
+        if (!ws.isVisited(des)) {
+            return false;
+        }
+        p.nodes.assign(base.begin(), base.begin() + j);
+        p.length = rootLength;
+        appendPath(p);
+        return true;
+    };
+
+    vector<Candidate> heap;
+    vector<Path> found;
+    std::set<vector<num_type>> seen;
+    std::greater<Candidate> cmp;
+    seen.insert(res[0].nodes);
+    auto push = [&](const Candidate &c) {
+        heap.push_back(c);
+        std::push_heap(heap.begin(), heap.end(), cmp);
+    };
+    auto addFound = [&](Path &p) {
+        if (seen.insert(p.nodes).second) {
+            found.push_back(Path());
+            found.back().length = p.length;
+            found.back().nodes.swap(p.nodes);
+            push(Candidate{found.back().length, true, found.size() - 1, 0, 0});
+        }
+    };
+    // Run or queue the spur searches of path i
+    auto expand = [&](const size_t i) {
+        weight_type rootLength = 0;
+        for (size_t j = 0; j + 1 < res[i].nodes.size(); ++j) {
+            if (in) {
+                auto bound = spurBound(i, j);
+                if (bound < INF) {
+                    push(Candidate{rootLength + bound, false, i, j, rootLength});
+                }
+            } else {
+                Path p;
+                if (spurSearch(i, j, rootLength, p)) {
+                    addFound(p);
+                }
+            }
+            rootLength += edgeWeight(res[i].nodes[j], res[i].nodes[j + 1]);
+        }
+    };
+    expand(0);
+    while ((num_type)res.size() < k && !heap.empty()) {
+        auto c = heap.front();
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        heap.pop_back();
+        if (c.exact) {
+            res.push_back(Path());
+            res.back().length = found[c.index].length;
+            res.back().nodes.swap(found[c.index].nodes);
+            expand(res.size() - 1);
+        } else {
+            Path p;
+            if (spurSearch(c.index, c.spur, c.rootLength, p)) {
+                addFound(p);
+            }
+        }
+    }
+    ws.clearMasks();
+}
+
+void AlgorithmGraph::testYen(Graph *g) {
+    cout << "Test Yen k shortest paths:\n\n";
+    cin.clear();
+    num_type src, des, k;
+    cout << "Input start vertex, end vertex and path number: ";
+    cin >> src >> des >> k;
+    CSRGraph out(g);
+    Workspace ws;
+    vector<Path> res, lazyRes;
+    yen(out, src, des, k, res, ws);
+    lazyYen(out, out.transpose(), src, des, k, lazyRes, ws);
+    for (const auto &p : res) {
+        cout << "(length: " << p.length << "): ";
+        for (size_t i = 0; i < p.nodes.size(); ++i) {
+            cout << (i ? " -> " : "") << p.nodes[i];
+        }
+        cout << endl;
+    }
+    bool same = res.size() == lazyRes.size();
+    for (size_t i = 0; same && i < res.size(); ++i) {
+        same = res[i].length == lazyRes[i].length;
+    }
+    cout << "Same lengths as the lazy variant: " << (same ? "yes" : "no") << endl;
+}
+
+AlgorithmGraph::PathResult AlgorithmGraph::deltaStepping(const CSRGraph &g, const num_type &src,
+                                                         weight_type delta, const unsigned threadNum) {
+    typedef CSRGraph::index_type index_type;
+    typedef CSRGraph::offset_type offset_type;
+    typedef unsigned long long bin_type;
+    typedef std::map<bin_type, vector<index_type>> bins_type;
+    const num_type n = g.size();
+    if (src < 0 || src >= n) {
+        throw std::range_error("AlgorithmGraph.deltaStepping(): start node is not valid");
+    }
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &offs = g.offsets();
+    if (delta <= 0) {
+        weight_type sum = 0;
+        for (const auto &w : g.weights()) {
+            sum += w;
+        }
+        delta = g.edgeCount() > 0 && sum > 0 ? sum / g.edgeCount() : 1;
+    }
+
+    // Reorder each adjacent list: light edges first, then heavy edges
+    vector<index_type> tgts(g.edgeCount());
+    vector<weight_type> wts(g.edgeCount());
+    vector<offset_type> lightEnd(n);
+    Parallel::forRange(0, n, [&](unsigned long long u) {
+        auto pos = offs[u];
+        for (int heavy = 0; heavy < 2; ++heavy) {
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                if ((g.weights()[j] >= delta) == (heavy == 1)) {
+                    tgts[pos] = g.targets()[j];
+                    wts[pos++] = g.weights()[j];
+                }
+            }
+            if (heavy == 0) {
+                lightEnd[u] = pos;
+            }
+        }
+    }, threads);
+
+    vector<std::atomic<weight_type>> dist(n);
+    vector<std::atomic<bool>> settled(n);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        dist[v].store(INF, std::memory_order_relaxed);
+        settled[v].store(false, std::memory_order_relaxed);
+    }, threads);
+    dist[src].store(0);
+
+    vector<bins_type> bins(threads);             // Buckets of each thread
+    vector<vector<index_type>> removed(threads);  // Nodes taken from current bucket
+    auto relax = [&](const unsigned t, const index_type v, const weight_type d) {
+        auto old = dist[v].load(std::memory_order_relaxed);
+        while (d < old) {
+            if (dist[v].compare_exchange_weak(old, d)) {
+                bins[t][(bin_type)(d / delta)].push_back(v);
+                break;
+            }
+        }
+    };
+
+    // The threads are started once and stay for all the buckets and
+    // phases, thread 0 collects the buckets between two barriers
+    vector<index_type> frontier(1, (index_type)src);
+    bin_type curBin = 0;
+    enum { LIGHT, HEAVY, DONE } phase = LIGHT;
+    const unsigned long long GRAIN = 64;
+    std::atomic<unsigned long long> next(0);
+    Parallel::Barrier barrier(threads);
+    // Move the nodes of current bucket from all the threads to the frontier
+    auto collect = [&]() {
+        frontier.clear();
+        for (auto &b : bins) {
+            auto it = b.find(curBin);
+            if (it != b.end()) {
+                frontier.insert(frontier.end(), it->second.begin(), it->second.end());
+                b.erase(it);
+            }
+        }
+        phase = frontier.empty() ? HEAVY : LIGHT;
+    };
+    // Relax the light edges of the frontier nodes still in current bucket
+    auto light = [&](const unsigned t, const unsigned long long lo, const unsigned long long hi) {
+        for (auto i = lo; i < hi; ++i) {
+            auto u = frontier[i];
+            auto du = dist[u].load(std::memory_order_relaxed);
+            if ((bin_type)(du / delta) != curBin) {
+                continue;  // Moved to an earlier bucket before
+            }
+            removed[t].push_back(u);
+            for (auto j = offs[u]; j < lightEnd[u]; ++j) {
+                relax(t, tgts[j], du + wts[j]);
+            }
+        }
+    };
+    // Relax the heavy edges of the settled nodes, once for each node
+    auto heavy = [&](const unsigned t, vector<index_type> &nodes) {
+        for (const auto &u : nodes) {
+            if (!settled[u].exchange(true)) {
+                auto du = dist[u].load(std::memory_order_relaxed);
+                for (auto j = lightEnd[u]; j < offs[u + 1]; ++j) {
+                    relax(t, tgts[j], du + wts[j]);
+                }
+            }
+        }
+        nodes.clear();
+    };
+    auto nextBucket = [&]() {  // Move to the next non-empty bucket
+        bool found = false;
+        for (const auto &b : bins) {
+            if (!b.empty() && (!found || b.begin()->first < curBin)) {
+                curBin = b.begin()->first;
+                found = true;
+            }
+        }
+        if (found) {
+            collect();
+        } else {
+            phase = DONE;
+        }
+    };
+    Parallel::run(threads, [&](unsigned t) {
+        while (1) {
+            if (t == 0) {
+                // Phases of one chunk are done by thread 0 alone, the
+                // others wait instead of meeting for each phase
+                while (1) {
+                    if (phase == LIGHT && frontier.size() <= GRAIN) {
+                        light(0, 0, frontier.size());
+                        collect();
+                    } else if (phase == HEAVY) {
+                        size_t count = 0;
+                        for (const auto &r : removed) {
+                            count += r.size();
+                        }
+                        if (count > GRAIN) {
+                            break;
+                        }
+                        for (auto &r : removed) {
+                            heavy(0, r);
+                        }
+                        nextBucket();
+                    } else {
+                        break;
+                    }
+                }
+                next.store(0);
+            }
+            barrier.wait();
+            if (phase == DONE) {
+                break;
+            }
+            if (phase == LIGHT) {
+                Parallel::takeChunks(next, frontier.size(), [&](unsigned long long lo, unsigned long long hi) {
+                    light(t, lo, hi);
+                }, GRAIN);
+                barrier.wait();
+                if (t == 0) {
+                    collect();
+                }
+            } else {
+                heavy(t, removed[t]);
+                barrier.wait();
+                if (t == 0) {
+                    nextBucket();
+                }
+            }
+        }
+    });
+
+    // Build the shortest path tree by BFS from the source over tight
+    // edges. Taking any tight edge into a node is not enough, as zero
+    // weight edges may then form cycles that never reach the source
+    PathResult res;
+    res.dist.resize(n);
+    res.prev.assign(n, NOT_NODE);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        res.dist[v] = dist[v].load(std::memory_order_relaxed);
+    }, threads);
+    vector<index_type> queue(1, (index_type)src);
+    vector<bool> reached(n, false);
+    reached[src] = true;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        auto u = queue[head];
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            auto v = tgts[j];
+            if (!reached[v] && res.dist[u] + wts[j] == res.dist[v]) {
+                reached[v] = true;
+                res.prev[v] = u;
+                queue.push_back(v);
+            }
+        }
+    }
+    return res;
+}
+
+void AlgorithmGraph::testDeltaStepping(Graph *g) {
+    cout << "Test delta-stepping:\n\n";
+    cin.clear();
+    num_type src;
+    weight_type delta;
+    cout << "Input start vertex and delta: ";
+    cin >> src >> delta;
+    CSRGraph csr(g);
+    auto res = deltaStepping(csr, src, delta);
+    auto expected = dijkstra(csr, src);
+    cout << "The shortest path:" << endl;
+    for (auto i = 0; i < g->size(); ++i) {
+        cout << "From node " << src << " to " << i
+            << " (length: " << res.dist[i] << "): ";
+        printPathTo(i, res.prev);
+        cout << endl;
+    }
+    cout << "Same distances as dijkstra: "
+        << (res.dist == expected.dist ? "yes" : "no") << endl;
+}
+
+double AlgorithmGraph::benchmarkThreads(const char *label, const unsigned maxThreads, double base,
+                                        const std::function<bool(unsigned)> &run,
+                                        const unsigned rounds) {
+    for (unsigned threads = 1; threads <= maxThreads; threads <<= 1) {
+        Timer timer;
+        bool correct = run(threads);
+        double time = timer.elapse() / rounds;
+        if (base <= 0) {
+            base = time;
+        }
+        printf("%s%2u thread(s): %10.2lf ms, speedup %5.2lf, check %s\n", label, threads, time,
+               time > 0 ? base / time : 0, correct ? "pass" : "failed");
+    }
+    return base;
+}
+
+void AlgorithmGraph::benchmarkDeltaStepping() {
+    cout << "Benchmark delta-stepping:\n\n";
+    cin.clear();
+    num_type side;
+    unsigned scale, maxThreads;
+    cout << "Input grid side length, R-MAT scale and max threads number: ";
+    cin >> side >> scale >> maxThreads;
+    cout << endl;
+    for (int kind = 0; kind < 2; ++kind) {
+        vector<Graph::Edge> edges;
+        num_type n;
+        weight_type delta;
+        if (kind == 0) {
+            n = side * side;
+            GraphGenerator::grid(side, side, 1, 100, edges);
+            delta = 50;
+            printf("Road-like graph (%ld x %ld grid):\n", side, side);
+        } else {
+            n = (num_type)1 << scale;
+            GraphGenerator::rmat(scale, 16, 1, 100, true, edges);
+            delta = 25;
+            printf("Power-law graph (R-MAT, scale %u):\n", scale);
+        }
+        CSRGraph csr(n, edges);
+        edges.clear();
+        printf("%ld nodes, %llu edges, delta %.0lf\n", n, csr.edgeCount(), delta);
+        Timer timer;
+        auto expected = dijkstra(csr, 0);
+        double base = timer.elapse();
+        printf("    dijkstra: %10.2lf ms\n", base);
+        benchmarkThreads("", maxThreads, base, [&](unsigned threads) {
+            return deltaStepping(csr, 0, delta, threads).dist == expected.dist;
+        });
+        cout << endl;
+    }
+}
+
+namespace {
+
+typedef AlgorithmGraph::num_type num_type;
+typedef AlgorithmGraph::weight_type weight_type;
+
+// Columns updated at a time by the min-plus kernel: 16 bytes is the
+// vector width every x86-64 and ARM64 target has without extra flags,
+// wider vectors are split into slow scalar code there
+const num_type LANES = 16 / sizeof(weight_type);
+typedef weight_type weight_vec __attribute__((vector_size(LANES * sizeof(weight_type))));
+typedef num_type node_vec __attribute__((vector_size(LANES * sizeof(num_type))));
+static_assert(sizeof(weight_type) == sizeof(num_type),
+              "the kernel selects previous nodes with the distance comparison mask");
+
+/*
+Min-plus kernel of Floyd-Warshall on one tile of an n x n matrix:
+for each k in [k0, k1), i in [i0, i1), j in [j0, j1),
+dist[i][j] = min(dist[i][j], dist[i][k] + dist[k][j]), and prev[i][j]
+takes prev[k][j] when the distance decreases. Unreachable entries
+are infinity, so no sum of them can look shorter.
+*/
+void minPlus(weight_type *dist, num_type *prev, const num_type n,
+             const num_type i0, const num_type i1, const num_type j0, const num_type j1,
+             const num_type k0, const num_type k1) {
+    for (auto k = k0; k < k1; ++k) {
+        const weight_type *rowK = dist + k * n;
+        const num_type *prevK = prev + k * n;
+        for (auto i = i0; i < i1; ++i) {
+            const weight_type dik = dist[i * n + k];
+            if (dik == std::numeric_limits<weight_type>::infinity()) {
+                continue;
+            }
+            weight_type *rowI = dist + i * n;
+            num_type *prevI = prev + i * n;
+            const weight_vec dikVec = weight_vec{} + dik;
+            auto j = j0;
+            for (; j + LANES <= j1; j += LANES) {
+                weight_vec c, b;
+                node_vec pc, pb;
+                std::memcpy(&c, rowI + j, sizeof(c));
+                std::memcpy(&b, rowK + j, sizeof(b));
+                std::memcpy(&pc, prevI + j, sizeof(pc));
+                std::memcpy(&pb, prevK + j, sizeof(pb));
+                weight_vec d = dikVec + b;
+                auto better = d < c;
+                c = better ? d : c;
+                pc = better ? pb : pc;
+                std::memcpy(rowI + j, &c, sizeof(c));
+                std::memcpy(prevI + j, &pc, sizeof(pc));
+            }
+            for (; j < j1; ++j) {
+                weight_type d = dik + rowK[j];
+                if (d < rowI[j]) {
+                    rowI[j] = d;
+                    prevI[j] = prevK[j];
+                }
+            }
+        }
+    }
+}
+
+}
+
+AlgorithmGraph::AllPairsResult AlgorithmGraph::floydWarshall(const CSRGraph &g,
+                                                             const unsigned threadNum) {
+    // Tile side, a tile of distances and one of previous nodes fit in L1 cache
+    const num_type TILE = 64;
+    const weight_type INFINITE = std::numeric_limits<weight_type>::infinity();
+    const num_type n = g.size();
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    AllPairsResult res;
+    res.n = n;
+    res.dist.resize(n * n);
+    res.prev.resize(n * n);
+    Parallel::forRange(0, n, [&](unsigned long long i) {
+        auto dist = res.dist.begin() + i * n;
+        auto prev = res.prev.begin() + i * n;
+        std::fill(dist, dist + n, INFINITE);
+        std::fill(prev, prev + n, NOT_NODE);
+        dist[i] = 0;
+        for (auto j = offs[i]; j < offs[i + 1]; ++j) {
+            auto v = tgts[j];
+            if (wts[j] < dist[v]) {  // Keep the shortest of parallel edges
+                dist[v] = wts[j];
+                prev[v] = i;
+            }
+        }
+    }, threads, 16);
+
+    weight_type *dist = res.dist.data();
+    num_type *prev = res.prev.data();
+    const num_type tiles = (n + TILE - 1) / TILE;
+    auto update = [&](const num_type ti, const num_type tj, const num_type tk) {
+        minPlus(dist, prev, n, ti * TILE, std::min(n, (ti + 1) * TILE),
+                tj * TILE, std::min(n, (tj + 1) * TILE), tk * TILE, std::min(n, (tk + 1) * TILE));
+    };
+    for (auto tk = 0; tk < tiles; ++tk) {
+        // The diagonal tile depends only on itself
+        update(tk, tk, tk);
+        // Tiles in row tk and column tk depend on themselves and the diagonal tile
+        Parallel::forRange(0, 2 * (tiles - 1), [&](unsigned long long x) {
+            num_type t = x / 2;
+            t += t >= tk;
+            if (x % 2 == 0) {
+                update(tk, t, tk);
+            } else {
+                update(t, tk, tk);
+            }
+        }, threads, 1);
+        // The other tiles depend on the tiles in their row and column
+        Parallel::forRange(0, (tiles - 1) * (tiles - 1), [&](unsigned long long x) {
+            num_type ti = x / (tiles - 1), tj = x % (tiles - 1);
+            ti += ti >= tk;
+            tj += tj >= tk;
+            update(ti, tj, tk);
+        }, threads, 1);
+    }
+
+    std::atomic<bool> negativeCycle(false);
+    Parallel::forRange(0, n, [&](unsigned long long i) {
+        if (dist[i * n + i] < 0) {
+            negativeCycle = true;
+        }
+        for (auto j = i * n; j < (i + 1) * n; ++j) {
+            if (dist[j] == INFINITE) {
+                dist[j] = INF;
+            }
+        }
+    }, threads, 16);
+    if (negativeCycle) {
+        throw std::range_error("AlgorithmGraph.floydWarshall(): graph contains a negative cycle");
+    }
+    return res;
+}
+
+AlgorithmGraph::AllPairsResult AlgorithmGraph::floydWarshall(const Graph *g,
+                                                             const unsigned threadNum) {
+    return floydWarshall(CSRGraph(g), threadNum);
+}
+
+void AlgorithmGraph::allPairsPath(const AllPairsResult &res, const num_type &src,
+                                  const num_type &des, vector<num_type> &path) {
+    if (src < 0 || src >= res.n || des < 0 || des >= res.n) {
+        throw std::range_error("AlgorithmGraph.allPairsPath(): node is not valid");
+    }
+    path.clear();
+    if (src != des && res.prev[src * res.n + des] == NOT_NODE) {
+        return;  // Unreachable
+    }
+    for (auto v = des; v != src; v = res.prev[src * res.n + v]) {
+        path.push_back(v);
+    }
+    path.push_back(src);
+    std::reverse(path.begin(), path.end());
+}
+
+void AlgorithmGraph::testFloydWarshall(Graph *g) {
+    cout << "Test Floyd-Warshall:\n\n";
+    cin.clear();
+    auto res = floydWarshall(g);
+    vector<num_type> path;
+    for (auto i = 0; i < res.n; ++i) {
+        for (auto j = 0; j < res.n; ++j) {
+            cout << "From node " << i << " to " << j;
+            allPairsPath(res, i, j, path);
+            if (path.empty()) {
+                cout << ": unreachable" << endl;
+                continue;
+            }
+            cout << " (length: " << res.dist[i * res.n + j] << "): ";
+            for (size_t k = 0; k < path.size(); ++k) {
+                cout << (k ? " -> " : "") << path[k];
+            }
+            cout << endl;
+        }
+    }
+}
+
+void AlgorithmGraph::benchmarkFloydWarshall() {
+    cout << "Benchmark Floyd-Warshall:\n\n";
+    cin.clear();
+    num_type n;
+    unsigned maxThreads;
+    cout << "Input node number and max threads number: ";
+    cin >> n >> maxThreads;
+    cout << endl;
+    // Dense graph: each node links to about a quarter of the others
+    auto random = Random::getInstance();
+    vector<Graph::Edge> edges;
+    for (auto i = 0; i < n; ++i) {
+        for (auto j = 0; j < n; ++j) {
+            if (i != j && random->randInt(0, 3) == 0) {
+                edges.push_back(Graph::Edge(i, j, (weight_type)random->randInt(1, 100)));
+            }
+        }
+    }
+    CSRGraph csr(n, edges);
+    edges.clear();
+    printf("%ld nodes, %llu edges\n", n, csr.edgeCount());
+    Timer timer;
+    vector<weight_type> expected(n * n);
+    for (auto i = 0; i < n; ++i) {
+        auto row = dijkstra(csr, i).dist;
+        std::copy(row.begin(), row.end(), expected.begin() + i * n);
+    }
+    double base = timer.elapse();
+    printf("dijkstra x %ld: %10.2lf ms\n", n, base);
+    benchmarkThreads("  ", maxThreads, base, [&](unsigned threads) {
+        return floydWarshall(csr, threads).dist == expected;
+    });
+    cout << endl;
+}
+
+bool AlgorithmGraph::bellmanFord(const CSRGraph &g, const num_type &src, PathResult &res,
+                                 vector<num_type> &cycle) {
+    const num_type n = g.size();
+    if (src < NOT_NODE || src >= n) {
+        throw std::range_error("AlgorithmGraph.bellmanFord(): start node is not valid");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    res.dist.assign(n, src == NOT_NODE ? 0 : INF);
+    res.prev.assign(n, NOT_NODE);
+    if (src != NOT_NODE) {
+        res.dist[src] = 0;
+    }
+    cycle.clear();
+    // After n - 1 rounds all the shortest paths are found, so a change
+    // in round n comes from a negative cycle
+    num_type changed = NOT_NODE;
+    for (auto round = 0; round < n; ++round) {
+        changed = NOT_NODE;
+        for (auto u = 0; u < n; ++u) {
+            if (res.dist[u] == INF) {
+                continue;  // INF plus a negative weight is not a distance
+            }
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto v = tgts[j];
+                if (res.dist[u] + wts[j] < res.dist[v]) {
+                    res.dist[v] = res.dist[u] + wts[j];
+                    res.prev[v] = u;
+                    changed = v;
+                }
+            }
+        }
+        if (changed == NOT_NODE) {
+            return true;
+        }
+    }
+    // The node changed last is on a negative cycle or reached from one
+    cycleFromPrev(res.prev, changed, cycle);
+    return false;
+}
+
+bool AlgorithmGraph::spfa(const CSRGraph &g, const num_type &src, PathResult &res,
+                          vector<num_type> &cycle) {
+    typedef CSRGraph::index_type index_type;
+    const num_type n = g.size();
+    if (src < NOT_NODE || src >= n) {
+        throw std::range_error("AlgorithmGraph.spfa(): start node is not valid");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    res.dist.assign(n, src == NOT_NODE ? 0 : INF);
+    res.prev.assign(n, NOT_NODE);
+    cycle.clear();
+    // Number of edges on the path found to each node
+    vector<num_type> edgeCnt(n, 0);
+    vector<bool> inQueue(n, false);
+    queue<index_type> q;
+    for (auto v = 0; v < n; ++v) {
+        if (src == NOT_NODE || v == src) {
+            res.dist[v] = 0;
+            inQueue[v] = true;
+            q.push((index_type)v);
+        }
+    }
+    while (!q.empty()) {
+        auto u = q.front();
+        q.pop();
+        inQueue[u] = false;
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            auto v = tgts[j];
+            if (res.dist[u] + wts[j] < res.dist[v]) {
+                res.dist[v] = res.dist[u] + wts[j];
+                res.prev[v] = u;
+                edgeCnt[v] = edgeCnt[u] + 1;
+                if (edgeCnt[v] >= n) {
+                    // A simple path has less than n edges
+                    cycleFromPrev(res.prev, v, cycle);
+                    if (cycle.empty()) {
+                        // The previous nodes changed since, find it the slow way
+                        bellmanFord(g, src, res, cycle);
+                    }
+                    return false;
+                }
+                if (!inQueue[v]) {
+                    inQueue[v] = true;
+                    q.push(v);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void AlgorithmGraph::cycleFromPrev(const vector<num_type> &prev, num_type v,
+                                   vector<num_type> &cycle) {
+    cycle.clear();
+    // The first node met twice is on the cycle
+    vector<num_type> pos(prev.size(), NOT_NODE), walk;
+    while (v != NOT_NODE && pos[v] == NOT_NODE) {
+        pos[v] = walk.size();
+        walk.push_back(v);
+        v = prev[v];
+    }
+    if (v == NOT_NODE) {
+        return;
+    }
+    // The walk goes against the edges
+    cycle.assign(walk.begin() + pos[v], walk.end());
+    std::reverse(cycle.begin(), cycle.end());
+}
+
+void AlgorithmGraph::testBellmanFord(Graph *g) {
+    cout << "Test Bellman-Ford and SPFA:\n\n";
+    cin.clear();
+    num_type src;
+    cout << "Input start vertex: ";
+    cin >> src;
+    CSRGraph csr(g);
+    PathResult res, other;
+    vector<num_type> cycle, otherCycle;
+    bool ok = bellmanFord(csr, src, res, cycle);
+    bool otherOk = spfa(csr, src, other, otherCycle);
+    if (!ok) {
+        cout << "Negative cycle:";
+        for (const auto &v : cycle) {
+            cout << " " << v;
+        }
+        cout << endl;
+    } else {
+        cout << "The shortest path:" << endl;
+        for (auto i = 0; i < g->size(); ++i) {
+            cout << "From node " << src << " to " << i;
+            if (res.dist[i] == INF) {
+                cout << ": unreachable" << endl;
+                continue;
+            }
+            cout << " (length: " << res.dist[i] << "): ";
+            printPathTo(i, res.prev);
+            cout << endl;
+        }
+    }
+    cout << "Same result as SPFA: "
+        << (ok == otherOk && (!ok || res.dist == other.dist) ? "yes" : "no") << endl;
+}
+
+AlgorithmGraph::AllPairsResult AlgorithmGraph::johnson(const CSRGraph &g,
+                                                       const unsigned threadNum) {
+    const num_type n = g.size();
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    PathResult potential;
+    vector<num_type> cycle;
+    if (!spfa(g, NOT_NODE, potential, cycle)) {
+        throw std::range_error("AlgorithmGraph.johnson(): graph contains a negative cycle");
+    }
+    const auto &h = potential.dist;
+    vector<Graph::Edge> edges;
+    edges.reserve(g.edgeCount());
+    for (auto u = 0; u < n; ++u) {
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            // Rounding may leave fractional weights slightly negative
+            auto w = std::max<weight_type>(0, wts[j] + h[u] - h[tgts[j]]);
+            edges.push_back(Graph::Edge(u, tgts[j], w));
+        }
+    }
+    CSRGraph reweighted(n, edges);
+    edges.clear();
+
+    AllPairsResult res;
+    res.n = n;
+    res.dist.resize(n * n);
+    res.prev.resize(n * n);
+    std::atomic<num_type> next(0);
+    Parallel::run(threadNum, [&](unsigned) {
+        Workspace ws;
+        while (1) {
+            auto s = next.fetch_add(1);
+            if (s >= n) {
+                break;
+            }
+            auto dist = res.dist.begin() + s * n;
+            auto prev = res.prev.begin() + s * n;
+            std::fill(dist, dist + n, INF);
+            std::fill(prev, prev + n, NOT_NODE);
+            dijkstra(reweighted, s, ws);
+            for (const auto &v : ws.touched()) {
+                // A path from s to v gains h(s) - h(v) by reweighting
+                dist[v] = ws.getDist(v) - h[s] + h[v];
+                prev[v] = ws.getPrev(v);
+            }
+        }
+    });
+    return res;
+}
+
+void AlgorithmGraph::testJohnson(Graph *g) {
+    cout << "Test Johnson:\n\n";
+    cin.clear();
+    CSRGraph csr(g);
+    auto res = johnson(csr);
+    vector<num_type> path;
+    for (auto i = 0; i < res.n; ++i) {
+        for (auto j = 0; j < res.n; ++j) {
+            cout << "From node " << i << " to " << j;
+            allPairsPath(res, i, j, path);
+            if (path.empty()) {
+                cout << ": unreachable" << endl;
+                continue;
+            }
+            cout << " (length: " << res.dist[i * res.n + j] << "): ";
+            for (size_t k = 0; k < path.size(); ++k) {
+                cout << (k ? " -> " : "") << path[k];
+            }
+            cout << endl;
+        }
+    }
+    cout << "Same distances as Floyd-Warshall: "
+        << (res.dist == floydWarshall(csr).dist ? "yes" : "no") << endl;
+}
+
+vector<double> AlgorithmGraph::pageRank(const CSRGraph &out, const CSRGraph &in,
+                                        const double damping, const double tolerance,
+                                        const unsigned maxIterations, const unsigned threadNum) {
+    const num_type n = out.size();
+    if (in.size() != n) {
+        throw std::range_error("AlgorithmGraph.pageRank(): graph sizes do not match");
+    }
+    if (n == 0) {
+        return vector<double>();
+    }
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &inOffs = in.offsets();
+    const auto &inTgts = in.targets();
+    vector<double> rank(n, 1.0 / n), next(n), share(n), invDegree(n);
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        auto d = out.degree(v);
+        invDegree[v] = d ? 1.0 / d : 0;
+    }, threads);
+    // Per chunk sums, added in order so the result does not depend on timing
+    const unsigned long long GRAIN = 4096;
+    const unsigned long long chunks = (n + GRAIN - 1) / GRAIN;
+    vector<double> chunkSum(chunks);
+    auto sum = [&]() {
+        double s = 0;
+        for (const auto &x : chunkSum) {
+            s += x;
+        }
+        return s;
+    };
+    for (unsigned it = 0; it < maxIterations; ++it) {
+        Parallel::forChunks(0, n, [&](unsigned, unsigned long long lo, unsigned long long hi) {
+            double dangling = 0;
+            for (auto v = lo; v < hi; ++v) {
+                share[v] = rank[v] * invDegree[v];
+                dangling += invDegree[v] == 0 ? rank[v] : 0;
+            }
+            chunkSum[lo / GRAIN] = dangling;
+        }, threads, GRAIN);
+        const double base = (1 - damping + damping * sum()) / n;
+        Parallel::forChunks(0, n, [&](unsigned, unsigned long long lo, unsigned long long hi) {
+            double diff = 0;
+            for (auto v = lo; v < hi; ++v) {
+                double s = 0;
+                for (auto j = inOffs[v]; j < inOffs[v + 1]; ++j) {
+                    s += share[inTgts[j]];
+                }
+                next[v] = base + damping * s;
+                diff += std::abs(next[v] - rank[v]);
+            }
+            chunkSum[lo / GRAIN] = diff;
+        }, threads, GRAIN);
+        rank.swap(next);
+        if (sum() < tolerance) {
+            break;
+        }
+    }
+    return rank;
+}
+
+void AlgorithmGraph::personalizedPageRank(const CSRGraph &out, const num_type &src,
+                                          vector<std::pair<num_type, double>> &res, Workspace &ws,
+                                          const double damping, const double epsilon) const {
+    const num_type n = out.size();
+    if (src < 0 || src >= n) {
+        throw std::range_error("AlgorithmGraph.personalizedPageRank(): source node is not valid");
+    }
+    const auto &offs = out.offsets();
+    const auto &tgts = out.targets();
+    // The residual is kept as the distance, the estimate in res at index count - 1
+    auto residual = [&](const num_type v) {
+        auto r = ws.getDist(v);
+        return r == Workspace::INF ? 0 : r;
+    };
+    auto threshold = [&](const num_type v) {
+        return epsilon * std::max<CSRGraph::offset_type>(out.degree(v), 1);
+    };
+    // A node is queued when its residual reaches its threshold, and
+    // stays so until pushed, so it is never queued twice at a time
+    auto add = [&](const num_type v, const double r) {
+        auto old = residual(v);
+        ws.setDist(v, old + r);
+        if (old < threshold(v) && old + r >= threshold(v)) {
+            ws.nodes.push_back(v);
+        }
+    };
+    ws.reset(n);
+    ws.nodes.clear();
+    res.clear();
+    ws.setDist(src, 1);
+    ws.nodes.push_back(src);
+    for (size_t head = 0; head < ws.nodes.size(); ++head) {
+        auto u = ws.nodes[head];
+        auto r = residual(u);
+        ws.setDist(u, 0);
+        if (ws.getCount(u) == 0) {
+            res.push_back(std::make_pair(u, 0.0));
+            ws.setCount(u, res.size());
+        }
+        res[ws.getCount(u) - 1].second += (1 - damping) * r;
+        if (offs[u] == offs[u + 1]) {
+            add(src, damping * r);  // The walk restarts at a dangling node
+            continue;
+        }
+        const double part = damping * r / (offs[u + 1] - offs[u]);
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            add(tgts[j], part);
+        }
+    }
+    std::sort(res.begin(), res.end(), [](const std::pair<num_type, double> &a,
+                                         const std::pair<num_type, double> &b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+}
+
+void AlgorithmGraph::testPageRank(Graph *g) {
+    cout << "Test PageRank:\n\n";
+    cin.clear();
+    num_type src;
+    cout << "Input source vertex of personalized PageRank: ";
+    cin >> src;
+    CSRGraph out(g);
+    auto rank = pageRank(out, out.transpose());
+    cout << "PageRank:" << endl;
+    for (auto v = 0; v < g->size(); ++v) {
+        printf("Node %ld: %.6lf\n", (long)v, rank[v]);
+    }
+    Workspace ws;
+    vector<std::pair<num_type, double>> res;
+    personalizedPageRank(out, src, res, ws);
+    cout << "Personalized PageRank of node " << src << ":" << endl;
+    for (const auto &p : res) {
+        printf("Node %ld: %.6lf\n", (long)p.first, p.second);
+    }
+}
+
+void AlgorithmGraph::benchmarkPageRank() {
+    cout << "Benchmark PageRank:\n\n";
+    cin.clear();
+    unsigned scale, maxThreads;
+    cout << "Input R-MAT scale and max threads number: ";
+    cin >> scale >> maxThreads;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::rmat(scale, 16, 1, 1, false, edges);
+    CSRGraph out((num_type)1 << scale, edges);
+    edges.clear();
+    auto in = out.transpose();
+    printf("Power-law graph (R-MAT, scale %u): %ld nodes, %llu edges\n",
+           scale, out.size(), out.edgeCount());
+    const unsigned ITERATIONS = 20;
+    printf("Time per iteration:\n");
+    vector<double> expected;
+    benchmarkThreads("", maxThreads, 0, [&](unsigned threads) {
+        // Tolerance 0 runs all the iterations
+        auto rank = pageRank(out, in, 0.85, 0, ITERATIONS, threads);
+        if (threads == 1) {
+            expected = rank;
+        }
+        return rank == expected;
+    }, ITERATIONS);
+    cout << endl;
+}
+
+namespace {
+
+// Nodes compared at a time by the vector scan
+const unsigned SCAN_LANES = 16 / sizeof(index_type);
+typedef index_type index_vec __attribute__((vector_size(SCAN_LANES * sizeof(index_type))));
+
+/*
+Call f(x) for each x in both sorted lists a[0, na) and b[0, nb).
+*/
+template <typename F>
+void mergeIntersect(const index_type *a, const offset_type na,
+                    const index_type *b, const offset_type nb, F f) {
+    offset_type i = 0, j = 0;
+    while (i < na && j < nb) {
+        // Advance without unpredictable branches
+        const auto x = a[i], y = b[j];
+        if (x == y) {
+            f(x);
+        }
+        i += x <= y;
+        j += y <= x;
+    }
+}
+
+/*
+Same as mergeIntersect, for a much shorter than b. For each node of a,
+exponential search in b bounds its position, binary search narrows
+the range, and a vector compare counts the nodes smaller than it.
+*/
+template <typename F>
+void gallopIntersect(const index_type *a, const offset_type na,
+                     const index_type *b, const offset_type nb, F f) {
+    const offset_type SCAN = 4 * SCAN_LANES;
+    offset_type lo = 0;
+    for (offset_type i = 0; i < na && lo < nb; ++i) {
+        const auto x = a[i];
+        // b[lo, hi) contains the position of x
+        offset_type step = 1, hi = lo;
+        while (hi < nb && b[hi] < x) {
+            lo = hi + 1;
+            hi += step;
+            step <<= 1;
+        }
+        hi = std::min(hi + 1, nb);
+        while (hi - lo > SCAN) {
+            auto mid = lo + (hi - lo) / 2;
+            if (b[mid] < x) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        const index_vec xv = index_vec{} + x;
+        auto k = lo;
+        offset_type smaller = 0;
+        for (; k + SCAN_LANES <= hi; k += SCAN_LANES) {
+            index_vec v;
+            std::memcpy(&v, b + k, sizeof(v));
+            auto less = v < xv;  // -1 where smaller
+            for (unsigned l = 0; l < SCAN_LANES; ++l) {
+                smaller -= less[l];
+            }
+        }
+        for (; k < hi; ++k) {
+            smaller += b[k] < x;
+        }
+        lo += smaller;
+        if (lo < nb && b[lo] == x) {
+            f(x);
+            ++lo;
+        }
+    }
+}
+
+}
+
+AlgorithmGraph::TriangleResult AlgorithmGraph::countTriangles(const CSRGraph &g,
+                                                              const unsigned gallopRatio,
+                                                              const unsigned threadNum) {
+    const num_type n = g.size();
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+
+    // Undirected adjacency, sorted and without duplicates
+    vector<offset_type> adjOffs(n + 1, 0);
+    for (auto u = 0; u < n; ++u) {
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            if (tgts[j] != (index_type)u) {
+                ++adjOffs[u + 1];
+                ++adjOffs[tgts[j] + 1];
+            }
+        }
+    }
+    for (auto u = 0; u < n; ++u) {
+        adjOffs[u + 1] += adjOffs[u];
+    }
+    vector<index_type> adj(adjOffs[n]);
+    {
+        auto pos = adjOffs;
+        for (auto u = 0; u < n; ++u) {
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto v = tgts[j];
+                if (v != (index_type)u) {
+                    adj[pos[u]++] = v;
+                    adj[pos[v]++] = (index_type)u;
+                }
+            }
+        }
+    }
+    vector<offset_type> degree(n);
+    Parallel::forRange(0, n, [&](unsigned long long u) {
+        auto first = adj.begin() + adjOffs[u], last = adj.begin() + adjOffs[u + 1];
+        std::sort(first, last);
+        degree[u] = std::unique(first, last) - first;
+    }, threads, 256);
+
+    // Keep the edges to higher ranked nodes, still sorted by number
+    auto higher = [&](const index_type u, const index_type v) {
+        return degree[u] < degree[v] || (degree[u] == degree[v] && u < v);
+    };
+    vector<offset_type> outOffs(n + 1, 0);
+    Parallel::forRange(0, n, [&](unsigned long long u) {
+        offset_type cnt = 0;
+        for (auto j = adjOffs[u]; j < adjOffs[u] + degree[u]; ++j) {
+            cnt += higher((index_type)u, adj[j]);
+        }
+        outOffs[u + 1] = cnt;
+    }, threads, 256);
+    for (auto u = 0; u < n; ++u) {
+        outOffs[u + 1] += outOffs[u];
+    }
+    vector<index_type> out(outOffs[n]);
+    Parallel::forRange(0, n, [&](unsigned long long u) {
+        auto k = outOffs[u];
+        for (auto j = adjOffs[u]; j < adjOffs[u] + degree[u]; ++j) {
+            if (higher((index_type)u, adj[j])) {
+                out[k++] = adj[j];
+            }
+        }
+    }, threads, 256);
+    adj = vector<index_type>();
+
+    vector<std::atomic<unsigned long long>> count(n);
+    Parallel::forRange(0, n, [&](unsigned long long u) {
+        count[u].store(0, std::memory_order_relaxed);
+    }, threads);
+    std::atomic<unsigned long long> total(0);
+    Parallel::forChunks(0, n, [&](unsigned, unsigned long long lo, unsigned long long hi) {
+        unsigned long long found = 0;
+        for (auto u = lo; u < hi; ++u) {
+            const index_type *a = out.data() + outOffs[u];
+            const offset_type na = outOffs[u + 1] - outOffs[u];
+            unsigned long long atU = 0;
+            for (offset_type i = 0; i < na; ++i) {
+                const auto v = a[i];
+                const index_type *b = out.data() + outOffs[v];
+                const offset_type nb = outOffs[v + 1] - outOffs[v];
+                unsigned long long atV = 0;
+                auto onTriangle = [&](const index_type w) {
+                    ++atV;
+                    count[w].fetch_add(1, std::memory_order_relaxed);
+                };
+                if (gallopRatio > 0 && na * gallopRatio <= nb) {
+                    gallopIntersect(a, na, b, nb, onTriangle);
+                } else if (gallopRatio > 0 && nb * gallopRatio <= na) {
+                    gallopIntersect(b, nb, a, na, onTriangle);
+                } else {
+                    mergeIntersect(a, na, b, nb, onTriangle);
+                }
+                if (atV) {
+                    count[v].fetch_add(atV, std::memory_order_relaxed);
+                    atU += atV;
+                }
+            }
+            if (atU) {
+                count[u].fetch_add(atU, std::memory_order_relaxed);
+                found += atU;
+            }
+        }
+        total += found;
+    }, threads, 64);
 
-bool AlgorithmGraph::isAllVisit() {
-    bool res = true;
-    for (const auto &v : visit) {
-        if (!v) {
-            res = false;
-        }
+    TriangleResult res;
+    res.total = total;
+    res.count.resize(n);
+    unsigned long long triples = 0;
+    for (auto u = 0; u < n; ++u) {
+        res.count[u] = count[u].load(std::memory_order_relaxed);
+        triples += degree[u] > 1 ? degree[u] * (degree[u] - 1) / 2 : 0;
     }
+    res.clustering = triples ? 3.0 * res.total / triples : 0;
     return res;
 }
 
-AlgorithmGraph::num_type AlgorithmGraph::getMinNotVisit(const Graph *g) {
-    num_type n = -1;
-    weight_type min = INF;
-    for (auto i = 0; i < g->size(); ++i) {
-        if (!visit[i] && dist[i] < min) {
-            min = dist[i];
-            n = i;
-        }
+void AlgorithmGraph::testTriangles(Graph *g) {
+    cout << "Test triangle counting:\n\n";
+    cin.clear();
+    auto res = countTriangles(CSRGraph(g));
+    for (auto v = 0; v < g->size(); ++v) {
+        cout << "Node " << v << ": " << res.count[v] << " triangle(s)" << endl;
     }
-    return n;
+    cout << "Total: " << res.total << " triangle(s), clustering coefficient "
+        << res.clustering << endl;
 }
 
-bool AlgorithmGraph::topoSort(Graph *g, vector<num_type> &res) {
-    res.clear();
-    num_type size = g->size(), nodeCnt = 0;
-    queue<size_t> q;
-    for (auto i = 0; i < size; ++i) {
-        res.push_back(0);  // Initialize result
-        if (indegree[i] == 0) {
-            q.push(i);
-        }
-    }
-    while (!q.empty()) {
-        auto n = q.front();
-        q.pop();
-        res[nodeCnt++] = n;  // Record result
-        vector<num_type> adjNodes;
-        g->getNeighbours(n, adjNodes);
-        for (const auto &adjN : adjNodes) {
-            if (--indegree[adjN] == 0) {
-                q.push(adjN);
+void AlgorithmGraph::benchmarkTriangles() {
+    cout << "Benchmark triangle counting:\n\n";
+    cin.clear();
+    unsigned scale, maxThreads;
+    cout << "Input R-MAT scale and max threads number: ";
+    cin >> scale >> maxThreads;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::rmat(scale, 16, 1, 1, false, edges);
+    CSRGraph csr((num_type)1 << scale, edges);
+    edges.clear();
+    printf("Power-law graph (R-MAT, scale %u): %ld nodes, %llu edges\n",
+           scale, csr.size(), csr.edgeCount());
+    TriangleResult expected;
+    double base = 0;
+    for (int gallop = 0; gallop < 2; ++gallop) {
+        const char *label = gallop ? " gallop, " : "  merge, ";
+        base = benchmarkThreads(label, maxThreads, base, [&](unsigned threads) {
+            auto res = countTriangles(csr, gallop ? 32 : 0, threads);
+            if (!gallop && threads == 1) {
+                expected = res;
+                printf("%llu triangles, clustering coefficient %.6lf\n", res.total, res.clustering);
             }
-        }
+            return res.count == expected.count;
+        });
     }
-    return nodeCnt == size;
+    cout << endl;
 }
 
-void AlgorithmGraph::testTopoSort(Graph *g) {
-    cout << "Test topological sort:\n\n";
-    cin.clear();
-    vector<num_type> res;
-    if (topoSort(g, res)) {
-        cout << "Graph contains no cycle\n"
-            << "Sort result: ";
-        for (unsigned i = 0; i < res.size(); ++i) {
-            cout << res[i] << " ";
+vector<double> AlgorithmGraph::betweenness(const CSRGraph &g, const bool weighted,
+                                           const num_type samples, const unsigned threadNum) {
+    typedef CSRGraph::index_type index_type;
+    typedef std::pair<weight_type, index_type> heap_node;
+    const num_type n = g.size();
+    const unsigned threads = Parallel::threadCount(threadNum);
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    vector<index_type> sources(n);
+    for (auto v = 0; v < n; ++v) {
+        sources[v] = (index_type)v;
+    }
+    num_type k = n;
+    if (samples > 0 && samples < n) {
+        // Partial Fisher-Yates shuffle
+        auto random = Random::getInstance();
+        for (auto i = 0; i < samples; ++i) {
+            std::swap(sources[i], sources[random->randInt(i, n - 1)]);
         }
-        cout << endl;
-    } else {
-        cout << "Graph contains cycle\n"
-            << "Sort failed" << endl;
+        k = samples;
     }
-}
 
-void AlgorithmGraph::dijkstra(Graph *g, const num_type &src) {
-    dist[src] = 0;
-    while (!isAllVisit()) {
-        auto n = getMinNotVisit(g);
-        visit[n] = true;
-        vector<num_type> adjNodes;
-        g->getNeighbours(n, adjNodes);
-        for (const auto &adjN : adjNodes) {
-            auto w = g->getWeight(n, adjN);
-            if (!visit[adjN] && dist[n] + w < dist[adjN]) {
-                dist[adjN] = dist[n] + w;
-                prev[adjN] = n;
+    vector<vector<double>> local(threads);
+    std::atomic<num_type> next(0);
+    Parallel::run(threads, [&](unsigned t) {
+        auto &centrality = local[t];
+        centrality.assign(n, 0);
+        // Per source state, reset through the visited nodes only
+        vector<weight_type> dist(n, INF);
+        vector<double> sigma(n, 0), delta(n, 0);
+        vector<index_type> order;  // Nodes by non-decreasing distance
+        vector<heap_node> heap;
+        std::greater<heap_node> cmp;
+        while (1) {
+            auto i = next.fetch_add(1);
+            if (i >= k) {
+                break;
+            }
+            auto s = sources[i];
+            order.clear();
+            dist[s] = 0;
+            sigma[s] = 1;
+            if (!weighted) {
+                order.push_back(s);
+                for (size_t head = 0; head < order.size(); ++head) {
+                    auto u = order[head];
+                    for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                        auto v = tgts[j];
+                        if (dist[v] == INF) {
+                            dist[v] = dist[u] + 1;
+                            order.push_back(v);
+                        }
+                        if (dist[v] == dist[u] + 1) {
+                            sigma[v] += sigma[u];
+                        }
+                    }
+                }
+            } else {
+                heap.assign(1, heap_node(0, s));
+                while (!heap.empty()) {
+                    auto d = heap.front().first;
+                    auto u = heap.front().second;
+                    std::pop_heap(heap.begin(), heap.end(), cmp);
+                    heap.pop_back();
+                    if (d > dist[u]) {
+                        continue;  // Outdated heap node
+                    }
+                    order.push_back(u);
+                    for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                        auto v = tgts[j];
+                        auto dv = dist[u] + wts[j];
+                        if (dv < dist[v]) {
+                            dist[v] = dv;
+                            sigma[v] = 0;
+                            heap.push_back(heap_node(dv, v));
+                            std::push_heap(heap.begin(), heap.end(), cmp);
+                        }
+                        if (dv == dist[v]) {
+                            sigma[v] += sigma[u];
+                        }
+                    }
+                }
+            }
+            // Successors on shortest paths come later in the order
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                auto u = *it;
+                double dep = 0;
+                for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                    auto v = tgts[j];
+                    if (dist[v] == dist[u] + (weighted ? wts[j] : 1)) {
+                        dep += sigma[u] / sigma[v] * (1 + delta[v]);
+                    }
+                }
+                delta[u] = dep;
+                if (u != s) {
+                    centrality[u] += dep;
+                }
+            }
+            for (const auto &u : order) {
+                dist[u] = INF;
+                sigma[u] = delta[u] = 0;
             }
         }
-    }
+    });
+
+    vector<double> res(n);
+    const double scale = (double)n / k;
+    Parallel::forRange(0, n, [&](unsigned long long v) {
+        double sum = 0;
+        for (unsigned t = 0; t < threads; ++t) {
+            sum += local[t][v];
+        }
+        res[v] = sum * scale;
+    }, threads);
+    return res;
 }
 
-void AlgorithmGraph::printPathTo(const num_type &des, const vector<num_type> &prev_) {
-    auto tmp = des;
-    if (prev_[tmp] != NOT_NODE) {
-        printPathTo(prev_[tmp], prev_);
-        cout << " -> ";
+void AlgorithmGraph::testBetweenness(Graph *g) {
+    cout << "Test betweenness centrality:\n\n";
+    cin.clear();
+    CSRGraph csr(g);
+    auto hops = betweenness(csr);
+    auto weighted = betweenness(csr, true);
+    for (auto v = 0; v < g->size(); ++v) {
+        printf("Node %ld: %.4lf (unweighted), %.4lf (weighted)\n", (long)v, hops[v], weighted[v]);
     }
-    cout << tmp;
 }
 
-void AlgorithmGraph::testDijkstra(Graph *g) {
-    cout << "Test dijkstra:\n\n";
+void AlgorithmGraph::benchmarkBetweenness() {
+    cout << "Benchmark betweenness centrality:\n\n";
     cin.clear();
-    num_type src;
-    cout << "Input start vertex: ";
-    cin >> src;
-    dijkstra(g, src);
-    cout << "The shortest path:" << endl;
-    for (auto i = 0; i < g->size(); ++i) {
-        cout << "From node " << src << " to " << i
-            << " (length: " << dist[i] << "): ";
-        printPathTo(i, prev);
-        cout << endl;
+    unsigned scale, maxThreads;
+    num_type samples;
+    cout << "Input R-MAT scale, sample number and max threads number: ";
+    cin >> scale >> samples >> maxThreads;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::rmat(scale, 8, 1, 1, true, edges);
+    CSRGraph csr((num_type)1 << scale, edges);
+    edges.clear();
+    printf("Undirected power-law graph (R-MAT, scale %u): %ld nodes, %llu edges\n",
+           scale, csr.size(), csr.edgeCount());
+    auto sameAs = [](const vector<double> &a, const vector<double> &b) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (std::abs(a[i] - b[i]) > 1e-9 * std::max(1.0, std::abs(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    vector<double> expected;
+    double base = benchmarkThreads("      exact, ", maxThreads, 0, [&](unsigned threads) {
+        auto res = betweenness(csr, false, 0, threads);
+        if (threads == 1) {
+            expected = res;
+        }
+        return sameAs(res, expected);
+    });
+    Timer timer;
+    auto estimate = betweenness(csr, false, samples, maxThreads);
+    double time = timer.elapse();
+    // Error on the top 1% nodes, which the estimate is for
+    vector<num_type> top(csr.size());
+    for (auto v = 0; v < csr.size(); ++v) {
+        top[v] = v;
     }
+    num_type cnt = std::max<num_type>(1, csr.size() / 100);
+    std::partial_sort(top.begin(), top.begin() + cnt, top.end(), [&](num_type a, num_type b) {
+        return expected[a] > expected[b];
+    });
+    double error = 0;
+    for (auto i = 0; i < cnt; ++i) {
+        error += std::abs(estimate[top[i]] - expected[top[i]]) / std::max(1.0, expected[top[i]]);
+    }
+    printf("%ld samples, %2u thread(s): %10.2lf ms, speedup %5.2lf, "
+           "mean relative error of top 1%% nodes %.4lf\n",
+           samples, maxThreads, time, time > 0 ? base / time : 0, error / cnt);
+    cout << endl;
 }
 
 void AlgorithmGraph::prim(Graph *g) {
@@ -197,6 +2747,43 @@ void AlgorithmGraph::prim(Graph *g) {
     }
 }
 
+void AlgorithmGraph::prim(const Graph *g, Workspace &ws) const {
+    typedef std::pair<weight_type, num_type> heap_node;
+    const num_type n = g->size();
+    ws.reset(n);
+    auto &q = ws.heap;
+    auto &adjNodes = ws.neighbours;
+    std::greater<heap_node> cmp;
+    q.clear();
+    for (auto s = 0; s < n; ++s) {
+        // Each unvisited node starts the tree of a new component
+        if (ws.isVisited(s)) {
+            continue;
+        }
+        ws.setDist(s, 0);
+        q.push_back(heap_node(0, s));
+        while (!q.empty()) {
+            auto u = q.front().second;
+            std::pop_heap(q.begin(), q.end(), cmp);
+            q.pop_back();
+            if (ws.isVisited(u)) {
+                continue;  // Outdated heap node
+            }
+            ws.setVisited(u);
+            g->getNeighbours(u, adjNodes);
+            for (const auto &v : adjNodes) {
+                auto w = g->getWeight(u, v);
+                if (!ws.isVisited(v) && w < ws.getDist(v)) {
+                    ws.setDist(v, w);
+                    ws.setPrev(v, u);
+                    q.push_back(heap_node(w, v));
+                    std::push_heap(q.begin(), q.end(), cmp);
+                }
+            }
+        }
+    }
+}
+
 void AlgorithmGraph::testPrim(Graph *g) {
     cout << "Test prim:\n\n";
     cin.clear();
@@ -210,6 +2797,128 @@ void AlgorithmGraph::testPrim(Graph *g) {
     cout << endl;
 }
 
+AlgorithmGraph::MSTResult AlgorithmGraph::kruskal(const Graph *g) {
+    MSTResult res;
+    vector<Graph::Edge> edges;
+    g->getEdges(edges);
+    std::sort(edges.begin(), edges.end(), [](const Graph::Edge &a, const Graph::Edge &b) {
+        return a.weight < b.weight;
+    });
+    DisjointSet s((DisjointSet::index_type)g->size());
+    for (const auto &e : edges) {
+        if (res.edges.size() + 1 >= (size_t)g->size()) {
+            break;  // Spanning tree is complete
+        }
+        if (s.union_((DisjointSet::index_type)e.from, (DisjointSet::index_type)e.to)) {
+            res.edges.push_back(e);
+            res.weight += e.weight;
+        }
+    }
+    return res;
+}
+
+void AlgorithmGraph::testKruskal(Graph *g) {
+    cout << "Test kruskal:\n\n";
+    cin.clear();
+    printMST(kruskal(g));
+}
+
+AlgorithmGraph::MSTResult AlgorithmGraph::boruvka(const Graph *g, const unsigned threadNum) {
+    typedef unsigned long long edge_id;
+    const edge_id NONE_EDGE = (edge_id)-1;
+    MSTResult res;
+    vector<Graph::Edge> edges;
+    g->getEdges(edges);
+    unsigned n = (unsigned)g->size();
+    ConcurrentDisjointSet s(n);
+    vector<unsigned> comp(n);  // Tree of each node in current round
+    for (unsigned i = 0; i < n; ++i) {
+        comp[i] = i;
+    }
+    vector<std::atomic<edge_id>> best(n);  // Lightest outgoing edge of each tree
+    vector<edge_id> alive(edges.size());   // Edges between different trees
+    for (edge_id i = 0; i < edges.size(); ++i) {
+        alive[i] = i;
+    }
+    // Strict total order of edges: by weight, then by index
+    auto lighter = [&](const edge_id a, const edge_id b) {
+        return edges[a].weight < edges[b].weight
+            || (edges[a].weight == edges[b].weight && a < b);
+    };
+    auto pick = [&](const unsigned c, const edge_id e) {
+        auto cur = best[c].load();
+        while ((cur == NONE_EDGE || lighter(e, cur))
+               && !best[c].compare_exchange_weak(cur, e)) {
+        }
+    };
+    unsigned threads = Parallel::threadCount(threadNum);
+    vector<vector<edge_id>> kept(threads), added(threads);
+    while (1) {
+        // Drop edges inside a tree
+        Parallel::run(threads, [&](unsigned t) {
+            auto lo = alive.size() * t / threads, hi = alive.size() * (t + 1) / threads;
+            kept[t].clear();
+            for (auto i = lo; i < hi; ++i) {
+                const auto &e = edges[alive[i]];
+                if (comp[e.from] != comp[e.to]) {
+                    kept[t].push_back(alive[i]);
+                }
+            }
+        });
+        alive.clear();
+        for (const auto &k : kept) {
+            alive.insert(alive.end(), k.begin(), k.end());
+        }
+        if (alive.empty()) {
+            break;
+        }
+        // Each tree picks its lightest outgoing edge
+        Parallel::forRange(0, n, [&](unsigned long long i) {
+            best[i].store(NONE_EDGE, std::memory_order_relaxed);
+        }, threads);
+        Parallel::forRange(0, alive.size(), [&](unsigned long long i) {
+            const auto &e = edges[alive[i]];
+            pick(comp[e.from], alive[i]);
+            pick(comp[e.to], alive[i]);
+        }, threads);
+        // Add the picked edges, an edge picked by both trees is added once
+        Parallel::run(threads, [&](unsigned t) {
+            added[t].clear();
+            for (auto c = (unsigned long long)t; c < n; c += threads) {
+                auto e = best[c].load();
+                if (e != NONE_EDGE && s.union_((unsigned)edges[e].from, (unsigned)edges[e].to)) {
+                    added[t].push_back(e);
+                }
+            }
+        });
+        for (const auto &a : added) {
+            for (const auto &e : a) {
+                res.edges.push_back(edges[e]);
+                res.weight += edges[e].weight;
+            }
+        }
+        Parallel::forRange(0, n, [&](unsigned long long i) {
+            comp[i] = s.find((unsigned)i);
+        }, threads);
+    }
+    return res;
+}
+
+void AlgorithmGraph::testBoruvka(Graph *g) {
+    cout << "Test boruvka:\n\n";
+    cin.clear();
+    printMST(boruvka(g));
+}
+
+void AlgorithmGraph::printMST(const MSTResult &res) {
+    cout << "The edges of the minimum spanning forest (weight: "
+        << res.weight << "):" << endl;
+    for (const auto &e : res.edges) {
+        cout << "(" << e.from << ", " << e.to << "), ";
+    }
+    cout << endl;
+}
+
 AlgorithmGraph::num_type AlgorithmGraph::hungarian(const num_type leftN, 
                                                    vector<num_type> &match,
                                                    Graph *g) {
@@ -228,6 +2937,54 @@ AlgorithmGraph::num_type AlgorithmGraph::hungarian(const num_type leftN,
     return maxMatch;
 }
 
+AlgorithmGraph::num_type AlgorithmGraph::hungarian(const num_type leftN,
+                                                   vector<num_type> &match,
+                                                   const Graph *g, Workspace &ws) const {
+    num_type maxMatch = 0;
+    auto &q = ws.nodes;
+    auto &adjNodes = ws.neighbours;
+    for (auto i = 0; i < leftN; ++i) {
+        if (match[i] != NOT_NODE) {
+            continue;
+        }
+        // BFS for an augmented path, the workspace clears visit and prev
+        ws.reset(g->size());
+        q.clear();
+        q.push_back(i);
+        bool found = false;
+        for (size_t head = 0; head < q.size() && !found; ++head) {
+            auto v = q[head];
+            g->getNeighbours(v, adjNodes);
+            for (const auto &adjN : adjNodes) {
+                if (ws.isVisited(adjN)) {
+                    continue;
+                }
+                ws.setVisited(adjN);
+                if (match[adjN] != NOT_NODE) {
+                    ws.setPrev(match[adjN], v);
+                    q.push_back(match[adjN]);
+                } else {
+                    auto a = v, b = adjN;
+                    // Reverse matching edge and unmatching edge
+                    while (a != NOT_NODE) {
+                        auto tmp = match[a];
+                        match[a] = b;
+                        match[b] = a;
+                        b = tmp;
+                        a = ws.getPrev(a);
+                    }
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (found) {
+            ++maxMatch;
+        }
+    }
+    return maxMatch;
+}
+
 bool AlgorithmGraph::findPath1(const num_type src,
                                vector<num_type> &match,
                                Graph *g) {
@@ -283,6 +3040,147 @@ bool AlgorithmGraph::findPath1(const num_type src,
     return false;  // No augmented path
 }
 
+AlgorithmGraph::num_type AlgorithmGraph::hopcroftKarp(const num_type leftN,
+                                                      vector<num_type> &match,
+                                                      const CSRGraph &g,
+                                                      const bool greedyInit) {
+    typedef CSRGraph::index_type index_type;
+    const num_type n = g.size();
+    if (leftN < 0 || leftN > n) {
+        throw std::range_error("AlgorithmGraph.hopcroftKarp(): left node number is not valid");
+    }
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto left = (index_type)leftN;
+    // 32-bit work arrays to keep the random accesses in cache
+    const index_type none = std::numeric_limits<index_type>::max();
+    vector<index_type> mate(n, none), layer(left), q, stack;
+    vector<CSRGraph::offset_type> current(left);
+    num_type maxMatch = 0;
+    if (greedyInit) {
+        for (index_type u = 0; u < left; ++u) {
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto v = tgts[j];
+                if (v >= left && mate[v] == none) {
+                    mate[u] = v;
+                    mate[v] = u;
+                    ++maxMatch;
+                    break;
+                }
+            }
+        }
+    }
+    while (1) {
+        // BFS from the unmatched left nodes, stop at the first layer
+        // that reaches an unmatched right node
+        q.clear();
+        for (index_type u = 0; u < left; ++u) {
+            layer[u] = mate[u] == none ? 0 : none;
+            if (layer[u] == 0) {
+                q.push_back(u);
+            }
+            current[u] = offs[u];
+        }
+        auto found = none;
+        for (size_t i = 0; i < q.size() && layer[q[i]] < found; ++i) {
+            auto u = q[i];
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                auto v = tgts[j];
+                if (v < left) {
+                    continue;
+                }
+                auto w = mate[v];
+                if (w == none) {
+                    found = layer[u];
+                } else if (layer[w] == none) {
+                    layer[w] = layer[u] + 1;
+                    q.push_back(w);
+                }
+            }
+        }
+        if (found == none) {  // No augmenting path
+            break;
+        }
+        // DFS along the layers from each unmatched left node
+        for (index_type root = 0; root < left; ++root) {
+            if (mate[root] != none || layer[root] != 0) {
+                continue;
+            }
+            stack.assign(1, root);
+            while (!stack.empty()) {
+                auto u = stack.back();
+                if (current[u] == offs[u + 1]) {
+                    // Dead end, never visit it again in this phase
+                    layer[u] = none;
+                    stack.pop_back();
+                    if (!stack.empty()) {
+                        ++current[stack.back()];
+                    }
+                    continue;
+                }
+                auto v = tgts[current[u]];
+                if (v < left) {
+                    ++current[u];
+                    continue;
+                }
+                auto w = mate[v];
+                if (w == none && layer[u] == found) {
+                    // Flip the path: each left node on the stack takes
+                    // the right node its current arc points to
+                    for (auto x : stack) {
+                        auto y = tgts[current[x]];
+                        mate[x] = y;
+                        mate[y] = x;
+                        layer[x] = none;
+                    }
+                    ++maxMatch;
+                    break;
+                }
+                if (w != none && layer[u] < found && layer[w] == layer[u] + 1) {
+                    stack.push_back(w);
+                } else {
+                    ++current[u];
+                }
+            }
+        }
+    }
+    match.assign(n, NOT_NODE);
+    for (num_type v = 0; v < n; ++v) {
+        if (mate[v] != none) {
+            match[v] = mate[v];
+        }
+    }
+    return maxMatch;
+}
+
+AlgorithmGraph::num_type AlgorithmGraph::hopcroftKarp(const num_type leftN,
+                                                      vector<num_type> &match,
+                                                      const Graph *g,
+                                                      const bool greedyInit) {
+    return hopcroftKarp(leftN, match, CSRGraph(g), greedyInit);
+}
+
+void AlgorithmGraph::testHopcroftKarp(Graph *g) {
+    cout << "Test Hopcroft-Karp:\n\n";
+    cin.clear();
+    cout << "Input left nodes number in the bipartite graph: ";
+    num_type leftN;
+    cin >> leftN;
+    vector<num_type> match;
+    cout << "Max matching number: " << hopcroftKarp(leftN, match, g) << endl;
+    cout << "Match edges:" << endl;
+    int cnt = 0;
+    for (auto i = 0; i < leftN; ++i) {
+        if (match[i] != NOT_NODE) {
+            cout << "(" << i << ", " << match[i] << "), ";
+        }
+        if ((++cnt) % 5 == 0) {
+            cout << endl;
+        }
+    }
+    cout << endl;
+}
+
 void AlgorithmGraph::testHungarian(Graph *g) {
     cout << "Test hungarian:\n\n";
     cin.clear();
@@ -431,6 +3329,123 @@ void AlgorithmGraph::testKM(Graph *g) {
     cout << endl;
 }
 
+template <typename T>
+T AlgorithmGraph::assignment(const vector<T> &cost, const num_type rows, const num_type cols,
+                             vector<num_type> &match, const bool max) {
+    // Potentials and path lengths in a wider type
+    typedef typename std::conditional<std::is_integral<T>::value, long long, double>::type value_type;
+    if (rows < 0 || cols < 0 || (size_t)rows * (size_t)cols != cost.size()) {
+        throw std::range_error("AlgorithmGraph.assignment(): matrix size is not valid");
+    }
+    match.assign(rows, NOT_NODE);
+    // Work on n <= m, transpose into a copy only if needed
+    const bool transposed = rows > cols;
+    const num_type n = transposed ? cols : rows, m = transposed ? rows : cols;
+    vector<T> copy;
+    if (transposed) {
+        copy.resize(cost.size());
+        for (num_type i = 0; i < rows; ++i) {
+            for (num_type j = 0; j < cols; ++j) {
+                copy[j * rows + i] = cost[i * cols + j];
+            }
+        }
+    }
+    const T *a = transposed ? copy.data() : cost.data();
+    const value_type sign = max ? -1 : 1;
+    const value_type inf = std::numeric_limits<value_type>::max();
+    // Column 0 is a fake column holding the row being added,
+    // p[j] is the row (1-based) assigned to column j, 0 if none
+    vector<value_type> u(n + 1, 0), v(m + 1, 0), minv(m + 1);
+    vector<num_type> p(m + 1, 0), way(m + 1, 0);
+    vector<char> used(m + 1);
+    for (num_type i = 1; i <= n; ++i) {
+        p[0] = i;
+        num_type j0 = 0;
+        std::fill(minv.begin(), minv.end(), inf);
+        std::fill(used.begin(), used.end(), 0);
+        do {
+            used[j0] = 1;
+            const num_type i0 = p[j0];
+            const T *row = a + (i0 - 1) * m;
+            const value_type ui0 = u[i0];
+            value_type delta = inf;
+            num_type j1 = 0;
+            for (num_type j = 1; j <= m; ++j) {
+                if (!used[j]) {
+                    value_type cur = sign * (value_type)row[j - 1] - ui0 - v[j];
+                    if (cur < minv[j]) {
+                        minv[j] = cur;
+                        way[j] = j0;
+                    }
+                    if (minv[j] < delta) {
+                        delta = minv[j];
+                        j1 = j;
+                    }
+                }
+            }
+            for (num_type j = 0; j <= m; ++j) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        // Flip the augmenting path back to the fake column
+        do {
+            num_type j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+    value_type sum = 0;
+    for (num_type j = 1; j <= m; ++j) {
+        if (p[j] != 0) {
+            auto r = p[j] - 1, c = j - 1;
+            if (transposed) {
+                std::swap(r, c);
+            }
+            match[r] = c;
+            sum += (value_type)cost[r * cols + c];
+        }
+    }
+    return (T)sum;
+}
+
+template float AlgorithmGraph::assignment<float>(const vector<float>&, const num_type, const num_type,
+                                                 vector<num_type>&, const bool);
+template double AlgorithmGraph::assignment<double>(const vector<double>&, const num_type, const num_type,
+                                                   vector<num_type>&, const bool);
+template long long AlgorithmGraph::assignment<long long>(const vector<long long>&, const num_type,
+                                                         const num_type, vector<num_type>&, const bool);
+
+void AlgorithmGraph::testAssignment() {
+    cout << "Test assignment:\n\n";
+    cin.clear();
+    num_type rows, cols;
+    cout << "Input rows and columns number: ";
+    cin >> rows >> cols;
+    cout << "Input cost matrix:" << endl;
+    vector<weight_type> cost(rows * cols);
+    for (auto &c : cost) {
+        cin >> c;
+    }
+    vector<num_type> match;
+    for (int k = 0; k < 2; ++k) {
+        bool max = k == 1;
+        cout << (max ? "Max" : "Min") << " cost: " << assignment(cost, rows, cols, match, max) << endl;
+        cout << (max ? "Max" : "Min") << " assignment: ";
+        for (auto i = 0; i < rows; ++i) {
+            if (match[i] != NOT_NODE) {
+                cout << "(" << i << ", " << match[i] << "), ";
+            }
+        }
+        cout << endl;
+    }
+}
+
 AlgorithmGraph::weight_type AlgorithmGraph::EdmondKarp(const num_type &src,
                                                        const num_type &des,
                                                        Graph *g) {
@@ -488,3 +3503,33 @@ void AlgorithmGraph::testEdmondKarp(Graph *g) {
     cin.clear();
     cout << "Max flow: " << EdmondKarp(0, g->size() - 1, g) << endl;
 }
+
+void AlgorithmGraph::testMaxFlow(Graph *g) {
+    cout << "Test max flow:\n\n";
+    cin.clear();
+    FlowNetwork net(g);
+    cout << "Dinic max flow: " << net.dinic(0, g->size() - 1) << endl;
+    cout << "Push-relabel max flow: " << net.pushRelabel(0, g->size() - 1) << endl;
+}
+
+AlgorithmGraph::weight_type AlgorithmGraph::minCostFlow(const num_type &src, const num_type &des,
+                                                        const Graph *capacity, const Graph *cost,
+                                                        weight_type &totalCost, const bool scaling) {
+    FlowNetwork net(capacity, cost);
+    auto res = scaling ? net.costScaling(src, des) : net.minCostFlow(src, des);
+    totalCost = (weight_type)res.cost;
+    return (weight_type)res.flow;
+}
+
+void AlgorithmGraph::testMinCostFlow(Graph *g) {
+    cout << "Test min cost flow:\n\nInput cost graph:\n";
+    cin.clear();
+    auto costGraph = createGraphFromInput();
+    weight_type cost;
+    for (int k = 0; k < 2; ++k) {
+        auto flow = minCostFlow(0, g->size() - 1, g, costGraph, cost, k == 1);
+        cout << (k == 1 ? "Cost scaling" : "Successive shortest paths")
+             << ": max flow " << flow << ", min cost " << cost << endl;
+    }
+    delete costGraph;
+}
@@ -2,6 +2,8 @@
 
 #include "Base.h"
 #include "Graph.h"
+#include "CSRGraph.h"
+#include <functional>
 
 NS_BEGIN
 
@@ -9,6 +11,12 @@ NS_BEGIN
 Contains algorithms for graph.
 This is a singleton.
 
+Some algorithms keep their state in arrays shared by the instance,
+which are set up by createGraphFromInput(). The overloads taking a
+Workspace keep all their state in it instead, so they can run on
+different threads at the same time, each thread with its own
+Workspace.
+
 For usage, see function test().
 */
 class AlgorithmGraph {
@@ -29,6 +37,124 @@ public:
     */
     static AlgorithmGraph* getInstance();
 
+    /*
+    Per-node state of one run of an algorithm, reused between runs.
+
+    Each node has a stamp, and its fields are only valid if the stamp
+    equals the current generation. reset() moves to a new generation
+    in O(1), and a node gets its default fields when it is first
+    written in the run, so a run costs O(nodes touched) instead of
+    O(n) to clear. The arrays only grow.
+
+    Default fields: dist = INF, prev = -1, count = 0, not visited.
+    */
+    class Workspace {
+    public:
+        // Distance of an unreachable node
+        static const weight_type INF;
+
+        Workspace();
+
+        /*
+        Start a new run on a graph.
+
+        @param n the number of nodes of the graph
+        */
+        void reset(const num_type n);
+
+        bool isVisited(const num_type v) const {
+            return visitStamp[v] == generation;
+        }
+
+        void setVisited(const num_type v) {
+            touch(v);
+            visitStamp[v] = generation;
+        }
+
+        weight_type getDist(const num_type v) const {
+            return stamp[v] == generation ? dist[v] : INF;
+        }
+
+        void setDist(const num_type v, const weight_type d) {
+            touch(v);
+            dist[v] = d;
+        }
+
+        num_type getPrev(const num_type v) const {
+            return stamp[v] == generation ? prev[v] : -1;
+        }
+
+        void setPrev(const num_type v, const num_type p) {
+            touch(v);
+            prev[v] = p;
+        }
+
+        num_type getCount(const num_type v) const {
+            return stamp[v] == generation ? count[v] : 0;
+        }
+
+        void setCount(const num_type v, const num_type c) {
+            touch(v);
+            count[v] = c;
+        }
+
+        /*
+        Return the nodes written in this run, in the order of
+        their first write.
+        */
+        const std::vector<num_type>& touched() const;
+
+        /*
+        Masks hide nodes and edges (by position in the CSR arrays)
+        from the CSR searches using this workspace, without copying
+        the graph. They are kept by reset() until clearMasks(), which
+        is O(1) with a generation of its own.
+        */
+        void clearMasks();
+        void maskNode(const num_type v);
+        void maskEdge(const CSRGraph::offset_type e);
+
+        bool hasMasks() const {
+            return masked;
+        }
+
+        bool isNodeMasked(const num_type v) const {
+            return v < (num_type)nodeMask.size() && nodeMask[v] == maskGeneration;
+        }
+
+        bool isEdgeMasked(const CSRGraph::offset_type e) const {
+            return e < edgeMask.size() && edgeMask[e] == maskGeneration;
+        }
+
+        // Scratch buffers kept between runs
+        std::vector<num_type> neighbours;
+        std::vector<num_type> nodes;
+        std::vector<std::pair<weight_type, num_type>> heap;
+
+    private:
+        unsigned generation;
+        std::vector<unsigned> stamp;
+        std::vector<unsigned> visitStamp;
+        std::vector<weight_type> dist;
+        std::vector<num_type> prev;
+        std::vector<num_type> count;
+        std::vector<num_type> touchedNodes;
+        bool masked;
+        unsigned maskGeneration;
+        std::vector<unsigned> nodeMask;
+        std::vector<unsigned> edgeMask;
+
+        void touch(const num_type v) {
+            if (stamp[v] != generation) {
+                stamp[v] = generation;
+                dist[v] = INF;
+                prev[v] = -1;
+                count[v] = 0;
+                touchedNodes.push_back(v);
+            }
+        }
+    };
+
     /*
     Topological sorting.
 
@@ -58,12 +184,174 @@ public:
     bool topoSort(Graph *g, std::vector<num_type> &res);
     void testTopoSort(Graph *g);
 
+    /*
+    Topological sorting with the in-degrees counted in a workspace,
+    so the graph can be sorted any number of times.
+
+    @param g the graph object
+    @param res the result will be stored in this field
+    @param ws the workspace
+    @return true if the graph contains no cycle
+    */
+    bool topoSort(const Graph *g, std::vector<num_type> &res, Workspace &ws) const;
+
+    /*
+    Definition of topological levels.
+    */
+    struct LevelResult {
+        std::vector<num_type> order;    // Nodes grouped by level
+        std::vector<num_type> offsets;  // Level i is order[offsets[i], offsets[i + 1])
+        std::vector<num_type> level;    // Level of each node, -1 if it is on a cycle
+                                        // or reachable from one
+    };
+
+    /*
+    Multi-threaded topological sorting by levels (wavefronts).
+    Level 0 holds the nodes without in-edges, and level i + 1 the
+    nodes whose in-edges all come from levels up to i, so all the
+    nodes of a level can be processed at the same time once the
+    previous levels are done. Each level is expanded in parallel
+    with atomic in-degree decrements, by threads which are started
+    once and meet at a barrier after each level. Levels of a few
+    nodes are done by one thread. The order inside a level is not
+    specified.
+    (time complexity: O(V+E))
+
+    Sample #1 of topoSort(): (ans: 0 | 1 | 2 | 5 | 4 | 3 7 | 6)
+
+    @param g the graph
+    @param res the result will be stored in this field
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return true if the graph contains no cycle
+    */
+    bool topoLevels(const CSRGraph &g, LevelResult &res, const unsigned threadNum = 0);
+    bool topoLevels(const Graph *g, LevelResult &res, const unsigned threadNum = 0);
+    void testTopoLevels(Graph *g);
+
+    /*
+    Definition of strongly connected components.
+    */
+    struct SCCResult {
+        std::vector<num_type> component;  // Component id of each node, in [0, count)
+        num_type count;                   // Number of components
+
+        SCCResult() : count(0) {}
+    };
+
+    /*
+    Tarjan algorithm for strongly connected components.
+    The search keeps its own stacks instead of recursing, so
+    graphs with very long paths do not overflow the call stack.
+    Components are numbered in reverse topological order: every
+    edge between two components goes to a smaller id.
+    (time complexity: O(V+E))
+
+    @param g the graph
+    @return the components
+    */
+    SCCResult tarjan(const CSRGraph &g);
+    SCCResult tarjan(const Graph *g);
+
+    /*
+    Multi-threaded forward-backward algorithm for strongly connected
+    components. (Fleischer et al., 2000; Hong et al., 2013)
+
+    Nodes without in-edges or out-edges among the remaining nodes
+    are trimmed in parallel as single components. Then from a pivot
+    of a large node set, the nodes reached both by a parallel forward
+    search and a parallel backward search form a component, and the
+    rest splits into three sets that share no component. Sets that
+    are small, or whose pivot component was small, are finished by
+    Tarjan searches running in parallel. The trimming and each search
+    start their threads once and go level by level, with a barrier
+    between levels. Levels of a few nodes are done by one thread.
+    Component ids are in no particular order.
+
+    @param out the graph
+    @param in the graph with all the edges reversed
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the components
+    @throw std::range_error if the two graphs have different sizes
+    */
+    SCCResult forwardBackward(const CSRGraph &out, const CSRGraph &in,
+                              const unsigned threadNum = 0);
+
+    /*
+    Build the condensation of a graph: each component becomes a node,
+    with one edge between two components if any edge joins them,
+    weighted by the smallest such edge. The result is a DAG.
+
+    @param g the graph
+    @param scc the components of g
+    @return the new graph, release it with delete
+    @throw std::range_error if the components do not match the graph
+    */
+    Graph* condensation(const CSRGraph &g, const SCCResult &scc);
+    void testSCC(Graph *g);
+
+    /*
+    Compare tarjan and forwardBackward on a generated power-law
+    (R-MAT) graph and on a ring, whose single component is as
+    deep as the graph.
+
+    Sample #1:
+    20 4
+    */
+    void benchmarkSCC();
+
+    /*
+    Result of a breadth-first search.
+    */
+    struct BFSResult {
+        std::vector<num_type> level;   // Hops from the source, -1 if unreachable
+        std::vector<num_type> parent;  // Parent in the search tree, -1 for the source
+                                       // and the unreachable nodes
+    };
+
+    /*
+    Direction-optimizing breadth-first search. (Beamer et al., 2012)
+
+    Each level is expanded either top-down (the frontier nodes claim
+    their unvisited out-neighbours with a CAS) or bottom-up (every
+    unvisited node looks for a parent among its in-neighbours in the
+    frontier bitmap and stops at the first one found). Bottom-up is
+    used while the frontier has many edges compared with the
+    unexplored part (mf > mu / 14), and top-down is used again once
+    the frontier shrinks below n / 24 nodes. Both directions are
+    split across threads, which are started once for the whole search
+    and meet at a barrier after each level. Top-down levels of a few
+    nodes are done by one thread.
+
+    @param out the graph
+    @param in the transpose of the graph (same as out if undirected)
+    @param src the start node
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the levels and parents of the nodes
+
+    Sample #1: (same as dijkstra, start vertex 2)
+
+    Answer #1:
+    From node 2 to 0 (hops: 4): 2 -> 4 -> 3 -> 1 -> 0
+    From node 2 to 1 (hops: 3): 2 -> 4 -> 3 -> 1
+    From node 2 to 2 (hops: 0): 2
+    From node 2 to 3 (hops: 2): 2 -> 4 -> 3
+    From node 2 to 4 (hops: 1): 2 -> 4
+    From node 2 to 5 (hops: 1): 2 -> 5
+    From node 2 to 6 (hops: 2): 2 -> 4 -> 6
+    From node 2 to 7 (hops: 2): 2 -> 4 -> 7
+    */
+    BFSResult bfs(const CSRGraph &out, const CSRGraph &in,
+                  const num_type &src, const unsigned threadNum = 0);
+    BFSResult bfs(const Graph *g, const num_type &src, const unsigned threadNum = 0);
+    void testBFS(Graph *g);
+
     /*
     Dijkstra algorithm
 
     If negative edges exist, avoid checking visited condition
     when traversing the adjacent nodes. Unfortuantely, this
-    will increase the time complexity.
+    will increase the time complexity. See bellmanFord(), spfa()
+    and johnson() for graphs with negative edges.
     
     @param g the graph object
     @param src the start node number
@@ -105,6 +393,387 @@ public:
     void printPathTo(const num_type &des, const std::vector<num_type> &prev_);
     void testDijkstra(Graph *g);
 
+    /*
+    Dijkstra with a binary heap, the distances and previous nodes
+    are left in the workspace (getDist(), getPrev()). On a CSRGraph
+    the nodes and edges masked in the workspace are skipped.
+    (time complexity: O((V+E)logV), only the reached part is touched)
+
+    @param g the graph
+    @param src the start node number
+    @param ws the workspace
+    @param des stop once this node is settled, -1 to search all
+    */
+    void dijkstra(const Graph *g, const num_type &src, Workspace &ws) const;
+    void dijkstra(const CSRGraph &g, const num_type &src, Workspace &ws,
+                  const num_type &des = -1) const;
+
+    /*
+    Compare running random local point-to-point queries on a generated
+    road-like graph with a fresh workspace per query, a reused
+    workspace, and one reused workspace per thread.
+
+    Sample #1:
+    1000 20000 4
+    */
+    void benchmarkWorkspace();
+
+    /*
+    Definition of a path.
+    */
+    struct Path {
+        weight_type length;           // Sum of the edge weights
+        std::vector<num_type> nodes;  // Nodes from the start to the end
+
+        Path() : length(0) {}
+    };
+
+    /*
+    Yen algorithm for the k shortest simple paths. (Yen, 1971)
+
+    The i-th path is the shortest path that deviates from each of the
+    first i - 1 paths. For each node of the last path found, a spur
+    search runs dijkstra from it with the nodes before it and the next
+    edges of the found paths with the same beginning masked in the
+    workspace, and the shortest of all these candidates is the next
+    path. Nodes joined by parallel edges count as one path.
+    (time complexity: O(kV(V+E)logV))
+
+    @param g the graph
+    @param src the start node
+    @param des the end node
+    @param k the number of paths
+    @param res at most k paths by non-decreasing length will be stored
+               in this field, fewer if there are not enough
+    @param ws the workspace
+    */
+    void yen(const CSRGraph &g, const num_type &src, const num_type &des, const num_type k,
+             std::vector<Path> &res, Workspace &ws) const;
+
+    /*
+    Lazy variant of yen(): the spur searches are not run when a path
+    is found, but queued with a lower bound of their result, the
+    length of the beginning plus the distance from the spur node to
+    des, from one backward dijkstra. A spur search only runs when its
+    bound becomes the smallest candidate, so most of them never run
+    for small k. The backward search stops at src, so the nodes farther
+    from des are bounded by the distance of src instead.
+
+    @param out the graph
+    @param in the graph with all the edges reversed
+    Other parameters and the result are the same as yen().
+    */
+    void lazyYen(const CSRGraph &out, const CSRGraph &in, const num_type &src,
+                 const num_type &des, const num_type k, std::vector<Path> &res,
+                 Workspace &ws) const;
+    void testYen(Graph *g);
+
+    /*
+    Result of a single-source shortest path search.
+    */
+    struct PathResult {
+        std::vector<weight_type> dist;  // Distance from the source, INF if unreachable
+        std::vector<num_type> prev;     // Previous node on the shortest path, -1 for
+                                        // the source and the unreachable nodes
+    };
+
+    /*
+    Dijkstra algorithm with a binary heap on a CSR graph.
+    (time complexity: O((V+E)logV))
+    Edge weights must be nonnegative.
+
+    @param g the graph
+    @param src the start node
+    @return the distances and the shortest path tree
+    */
+    PathResult dijkstra(const CSRGraph &g, const num_type &src);
+
+    /*
+    Delta-stepping algorithm for single-source shortest path.
+    (Meyer and Sanders, 2003)
+
+    Nodes are kept in buckets of width delta by tentative distance.
+    The smallest non-empty bucket is processed in phases: its nodes
+    relax their light edges (weight < delta) in parallel, which may
+    put nodes back into the same bucket, until it stays empty. Then
+    the heavy edges of all the nodes settled in the bucket are relaxed
+    once. Distances are updated with an atomic min, and each thread
+    has its own buckets. The threads are started once for the whole
+    run and meet at a barrier after each phase, and phases of a few
+    nodes are done by one thread. A small delta approaches Dijkstra
+    (little parallelism), a large one approaches Bellman-Ford (more
+    work). Edge weights must be nonnegative.
+
+    @param g the graph
+    @param src the start node
+    @param delta the bucket width, 0 to use the average edge weight
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the distances and a shortest path tree, same distances
+            as dijkstra()
+
+    Sample #1: (same as dijkstra, delta 3)
+    */
+    PathResult deltaStepping(const CSRGraph &g, const num_type &src,
+                             weight_type delta = 0, const unsigned threadNum = 0);
+    void testDeltaStepping(Graph *g);
+
+    /*
+    Compare delta-stepping with dijkstra on generated road-like
+    (grid) and power-law (R-MAT) graphs with different numbers
+    of threads.
+
+    Sample #1:
+    1000 18 8
+    */
+    void benchmarkDeltaStepping();
+
+    /*
+    Definition of all pairs shortest paths, as flat row-major matrices.
+    */
+    struct AllPairsResult {
+        num_type n;                     // Number of nodes
+        std::vector<weight_type> dist;  // dist[i * n + j] from i to j, INF if unreachable
+        std::vector<num_type> prev;     // prev[i * n + j] is the node before j on the
+                                        // shortest path from i, -1 if none
+
+        AllPairsResult() : n(0) {}
+    };
+
+    /*
+    Blocked Floyd-Warshall algorithm for all pairs shortest paths.
+    (Venkataraman et al., 2003)
+
+    The matrix is split into square tiles that fit in the cache. For
+    each block of intermediate nodes, the diagonal tile is updated
+    first, then the tiles in its row and column in parallel, then all
+    the other tiles in parallel. The min-plus kernel works on several
+    columns at a time with vector instructions.
+    Negative edges are allowed.
+    (time complexity: O(V^3), space complexity: O(V^2))
+
+    @param g the graph
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the distances and the previous nodes
+    @throw std::range_error if the graph contains a negative cycle
+    */
+    AllPairsResult floydWarshall(const CSRGraph &g, const unsigned threadNum = 0);
+    AllPairsResult floydWarshall(const Graph *g, const unsigned threadNum = 0);
+
+    /*
+    Get the shortest path between two nodes from all pairs shortest paths.
+
+    @param res the all pairs shortest paths
+    @param src the start node
+    @param des the end node
+    @param path the nodes from src to des will be stored in this field,
+                empty if des is unreachable
+    */
+    void allPairsPath(const AllPairsResult &res, const num_type &src, const num_type &des,
+                      std::vector<num_type> &path);
+    void testFloydWarshall(Graph *g);
+
+    /*
+    Compare floydWarshall with running dijkstra from every node on
+    a generated dense graph with different numbers of threads.
+
+    Sample #1:
+    1000 4
+    */
+    void benchmarkFloydWarshall();
+
+    /*
+    Bellman-Ford algorithm for single source shortest paths with
+    negative edges. Every round relaxes all the edges, and the search
+    stops early after a round that changes nothing.
+    (time complexity: O(VE))
+
+    If a negative cycle is reachable, the shortest paths do not
+    exist, and one such cycle is returned instead.
+
+    Sample #1: (start from 0, negative cycle 1 -> 2 -> 3 -> 1)
+    4 0
+    0 1 0 0
+    0 0 2 0
+    0 0 0 -4
+    0 1 0 0
+
+    @param g the graph
+    @param src the start node, or -1 to start from all the nodes at
+               distance 0, as if a new node linked to all of them
+               by edges of weight 0
+    @param res the distances and previous nodes will be stored in this field
+    @param cycle the nodes of a negative cycle in edge order will be
+                 stored in this field, empty if there is none
+    @return true if no negative cycle is reachable
+    */
+    bool bellmanFord(const CSRGraph &g, const num_type &src, PathResult &res,
+                     std::vector<num_type> &cycle);
+
+    /*
+    Shortest path faster algorithm: Bellman-Ford that only relaxes
+    the edges of the nodes whose distance changed, kept in a queue.
+    A node whose path reaches n edges proves a negative cycle.
+    Usually much faster than bellmanFord, with the same worst case.
+    (time complexity: O(VE))
+
+    The parameters and the result are the same as bellmanFord().
+    */
+    bool spfa(const CSRGraph &g, const num_type &src, PathResult &res,
+              std::vector<num_type> &cycle);
+    void testBellmanFord(Graph *g);
+
+    /*
+    Johnson algorithm for all pairs shortest paths with negative edges.
+    The potentials h from spfa() make every edge weight w(u, v) + h(u) - h(v)
+    non-negative without changing the shortest paths, then dijkstra
+    runs from each node on the reweighted graph, in parallel with one
+    workspace per thread. Faster than floydWarshall on sparse graphs.
+    (time complexity: O(VE + V(V+E)logV))
+
+    @param g the graph
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the distances and the previous nodes
+    @throw std::range_error if the graph contains a negative cycle
+    */
+    AllPairsResult johnson(const CSRGraph &g, const unsigned threadNum = 0);
+    void testJohnson(Graph *g);
+
+    /*
+    Multi-threaded PageRank by power iteration. Edge weights are ignored.
+
+    Each iteration first stores rank / out-degree of every node in a
+    contiguous array, then every node pulls the values of its in-edges
+    from the reverse graph, so no two threads write the same score.
+    The rank of dangling nodes (no out-edges) is spread over all the
+    nodes, so the ranks always sum to 1.
+
+    @param out the graph
+    @param in the graph with all the edges reversed
+    @param damping the probability of following an edge
+    @param tolerance stop when the ranks change less than this in total
+    @param maxIterations stop after this number of iterations
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the rank of each node
+    @throw std::range_error if the two graphs have different sizes
+    */
+    std::vector<double> pageRank(const CSRGraph &out, const CSRGraph &in,
+                                 const double damping = 0.85, const double tolerance = 1e-9,
+                                 const unsigned maxIterations = 100, const unsigned threadNum = 0);
+
+    /*
+    Personalized PageRank of one node by forward push. (Andersen et al., 2006)
+
+    Each node has an estimate and a residual, starting with residual 1
+    at the source. Pushing a node moves (1 - damping) of its residual
+    into its estimate and spreads the rest over its out-neighbours
+    (back to the source for a dangling node). Only nodes whose residual
+    reaches epsilon times their out-degree are pushed, so the work
+    depends on epsilon and not on the graph size, and only the touched
+    nodes are kept in the workspace.
+
+    @param out the graph
+    @param src the source node
+    @param res the (node, estimate) pairs of the nodes with an estimate
+               will be stored in this field, by decreasing estimate
+    @param ws the workspace
+    @param damping the probability of following an edge
+    @param epsilon the residual threshold per out-edge
+    */
+    void personalizedPageRank(const CSRGraph &out, const num_type &src,
+                              std::vector<std::pair<num_type, double>> &res, Workspace &ws,
+                              const double damping = 0.85, const double epsilon = 1e-7) const;
+    void testPageRank(Graph *g);
+
+    /*
+    Run pageRank on a generated power-law (R-MAT) graph with
+    different numbers of threads.
+
+    Sample #1:
+    20 4
+    */
+    void benchmarkPageRank();
+
+    /*
+    Definition of triangle counts.
+    */
+    struct TriangleResult {
+        unsigned long long total;               // Number of triangles
+        std::vector<unsigned long long> count;  // Triangles through each node
+        double clustering;                      // Global clustering coefficient:
+                                                // 3 * triangles / connected triples
+
+        TriangleResult() : total(0), clustering(0) {}
+    };
+
+    /*
+    Multi-threaded triangle counting. The graph is taken as undirected,
+    without self loops and parallel edges.
+
+    Each edge is directed from the node of smaller degree (then
+    smaller number) to the other, which leaves every node at most
+    O(sqrt(E)) out-neighbours. Each triangle is then found once, at
+    its lowest node u, as a common out-neighbour of u and of one of
+    its out-neighbours v, by intersecting the two sorted lists.
+    Lists of similar sizes are merged. When one is much longer, each
+    node of the short list gallops in the long one, and finishes
+    with a vector compare of a few nodes at a time.
+    (time complexity: O(E^1.5))
+
+    @param g the graph
+    @param gallopRatio gallop when the longer list is at least this
+                       times longer, 0 to always merge
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the triangle counts and the clustering coefficient
+    */
+    TriangleResult countTriangles(const CSRGraph &g, const unsigned gallopRatio = 32,
+                                  const unsigned threadNum = 0);
+    void testTriangles(Graph *g);
+
+    /*
+    Compare merging and galloping in countTriangles on a generated
+    power-law (R-MAT) graph with different numbers of threads.
+
+    Sample #1:
+    18 4
+    */
+    void benchmarkTriangles();
+
+    /*
+    Brandes algorithm for betweenness centrality. (Brandes, 2001)
+
+    The betweenness of a node is the sum, over all pairs (s, t) of
+    other nodes, of the fraction of shortest paths from s to t through
+    it. From each source, a search (BFS, or dijkstra if weighted)
+    counts the shortest paths to every node, then the nodes are taken
+    in reverse order of distance to add up the dependency of the
+    source on each node. Sources run in parallel, each thread adds to
+    its own array and the arrays are summed at the end.
+    An undirected graph stored with edges in both directions gets
+    twice the undirected values.
+    (time complexity: O(VE) unweighted, O(VE + V^2logV) weighted)
+
+    @param g the graph
+    @param weighted use the edge weights (must be positive) if true,
+                    count edges otherwise
+    @param samples the number of random sources to estimate from, the
+                   result is scaled by n / samples; 0 for all the nodes
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the betweenness of each node
+    */
+    std::vector<double> betweenness(const CSRGraph &g, const bool weighted = false,
+                                    const num_type samples = 0, const unsigned threadNum = 0);
+    void testBetweenness(Graph *g);
+
+    /*
+    Compare exact betweenness with different numbers of threads and
+    the estimate from sampled sources on a generated undirected
+    power-law (R-MAT) graph.
+
+    Sample #1:
+    14 256 4
+    */
+    void benchmarkBetweenness();
+
     /*
     Prim algorithm to find minimum spanning tree (undirected graph).
     A minimun spanning tree exists iff the undirected graph is connected.
@@ -127,8 +796,64 @@ public:
     (0, 1), (1, 2), (4, 3), (1, 4), (7, 5), (7, 6), (4, 7),
     */
     void prim(Graph *g);
+
+    /*
+    Prim algorithm with a binary heap, the tree edge to each node v
+    is (ws.getPrev(v), v). A disconnected graph gets a spanning forest.
+
+    @param g the graph object
+    @param ws the workspace
+    */
+    void prim(const Graph *g, Workspace &ws) const;
     void testPrim(Graph *g);
 
+    /*
+    Result of a minimum spanning forest.
+    */
+    struct MSTResult {
+        std::vector<Graph::Edge> edges;  // Edges in the forest
+        weight_type weight;              // Total weight of the edges
+
+        MSTResult() : weight(0) {}
+    };
+
+    /*
+    Kruskal algorithm to find minimum spanning forest (undirected graph).
+    Sort the edges by weight and add each edge that joins two trees,
+    using a disjoint set. (time complexity: O(ElogE))
+    The graph does not need to be connected.
+
+    @param g the graph object
+    @return the edges of the forest and their total weight
+
+    Sample #1: (same as prim)
+
+    Answer #1: (edge order and direction not unique)
+    The edges of the minimum spanning forest (weight: 19):
+    (7, 6), (4, 1), (4, 3), (2, 1), (1, 0), (4, 7), (5, 7),
+    */
+    MSTResult kruskal(const Graph *g);
+    void testKruskal(Graph *g);
+
+    /*
+    Boruvka algorithm to find minimum spanning forest (undirected graph).
+    In each round, every tree picks its lightest outgoing edge in
+    parallel, the picked edges are added with a ConcurrentDisjointSet,
+    and edges inside a tree are dropped. Ties are broken by edge index
+    so that the picked edges never form a cycle. At least half of the
+    trees are merged in each round. (time complexity: O(ElogV))
+    The graph does not need to be connected.
+
+    @param g the graph object
+    @param threadNum the number of threads, 0 for all hardware threads
+    @return the edges of the forest and their total weight
+
+    Sample #1: (same as prim)
+    */
+    MSTResult boruvka(const Graph *g, const unsigned threadNum = 0);
+    void testBoruvka(Graph *g);
+    void printMST(const MSTResult &res);
+
     /*
     Hungarian algorithm to find the maximum matching number
     in an unweighted bipartite graph.
@@ -178,9 +903,44 @@ public:
     4
     */
     num_type hungarian(const num_type leftN, std::vector<num_type> &match, Graph *g);
+
+    /*
+    Same as above, but the visit marks of each search are cleared
+    in O(1) by the workspace.
+    */
+    num_type hungarian(const num_type leftN, std::vector<num_type> &match,
+                       const Graph *g, Workspace &ws) const;
     bool findPath1(const num_type src, std::vector<num_type> &match, Graph *g);
     void testHungarian(Graph *g);
 
+    /*
+    Hopcroft-Karp algorithm to find the maximum matching number
+    in an unweighted bipartite graph. (time complexity: O(E * sqrt(V)))
+
+    Each phase runs a BFS from all the unmatched left nodes to build
+    the layers of the shortest alternating paths, then a DFS with
+    current-arc pointers augments along a maximal set of
+    vertex-disjoint shortest paths. Only the edges from left nodes
+    to right nodes are used.
+
+    Precondition: the graph must be a bipartite graph.
+
+    @param leftN the left node number of the bipartite graph,
+                 nodes [0, leftN) are left and the others are right
+    @param match same format as hungarian(), resized to the node
+                 number and filled from scratch
+    @param g the graph object
+    @param greedyInit whether to start from a greedy matching
+    @return the maximum matching number of the graph
+
+    Samples: same as hungarian().
+    */
+    num_type hopcroftKarp(const num_type leftN, std::vector<num_type> &match,
+                          const CSRGraph &g, const bool greedyInit = true);
+    num_type hopcroftKarp(const num_type leftN, std::vector<num_type> &match,
+                          const Graph *g, const bool greedyInit = true);
+    void testHopcroftKarp(Graph *g);
+
     /*
     KuhnCMunkres algorithm to find optimum(maximum sum of weight)
     matching in a weighted bipartite graph. (time complexity: O(n^4))
@@ -199,6 +959,8 @@ public:
                else it has minimum sum of weight.
     @return the sum of weight in the optimum matching
 
+    For a dense cost matrix, see assignment(). (time complexity: O(n^3))
+
     Sample #1:
     5 1
     0 0 9 5 7
@@ -260,6 +1022,49 @@ public:
                    std::vector<num_type> &match, Graph *g);
     void testKM(Graph *g);
 
+    /*
+    Hungarian algorithm with shortest augmenting paths to solve the
+    assignment problem on a dense cost matrix. (time complexity: O(n^2 * m))
+
+    Rows are added one at a time. For each row, a Dijkstra-like scan
+    over the columns with reduced costs (cost - u[row] - v[col]) finds
+    the cheapest augmenting path, then the potentials u and v are
+    updated so that all reduced costs stay nonnegative. Tightness is
+    never tested with ==, so floating point costs are safe.
+
+    If rows > cols, the transposed problem is solved instead, so
+    min(rows, cols) pairs are always assigned.
+
+    T can be float, double or long long. The input is not changed.
+
+    @param cost the cost matrix in row-major order, cost[i * cols + j]
+                is the cost to assign row i to column j
+    @param rows the number of rows
+    @param cols the number of columns
+    @param match if match[i] = j, row i is assigned to column j.
+                 if match[i] = -1, row i is not assigned.
+    @param max if max is true, maximize the sum of cost instead
+    @return the sum of cost of the assignment
+
+    Sample #1: (same as km() sample #2, left nodes as rows)
+    5 5
+    3 4 6 4 9
+    6 4 5 3 8
+    7 5 3 4 2
+    6 3 2 2 5
+    8 4 5 4 7
+
+    Answer #1:
+    Min cost: 14
+    Min assignment: (0, 0), (1, 3), (2, 4), (3, 2), (4, 1),
+    Max cost: 29
+    Max assignment: (0, 4), (1, 2), (2, 1), (3, 0), (4, 3),
+    */
+    template <typename T>
+    T assignment(const std::vector<T> &cost, const num_type rows, const num_type cols,
+                 std::vector<num_type> &match, const bool max = false);
+    void testAssignment();
+
     /*
     Edmond-Karp's algorithm to solve maximum flow problem.
 
@@ -267,6 +1072,8 @@ public:
     src: node[0];
     des: node[node_num - 1];
 
+    For large sparse networks, see FlowNetwork, or testMaxFlow().
+
     @param src the start node
     @param des the destination node
     @param g the graph object (need to use adjacent matrix)
@@ -294,6 +1101,57 @@ public:
     weight_type getIncreaseFromPath(const num_type &src, const num_type &des, Graph *g);
     void testEdmondKarp(Graph *g);
 
+    /*
+    Solve the maximum flow problem with Dinic's algorithm and
+    push-relabel on a FlowNetwork built from the graph.
+    The graph is not changed.
+
+    Default:
+    src: node[0];
+    des: node[node_num - 1];
+
+    Samples: same as EdmondKarp().
+    */
+    void testMaxFlow(Graph *g);
+
+    /*
+    Solve the minimum cost maximum flow problem on a FlowNetwork
+    built from a capacity graph and a cost graph of the same size.
+    Capacities and costs are rounded to integers.
+
+    Default:
+    src: node[0];
+    des: node[node_num - 1];
+
+    @param src the start node
+    @param des the destination node
+    @param capacity the capacity graph
+    @param cost the cost graph, cost of edge (u, v) per unit of flow
+    @param totalCost the minimum cost will be stored in this field
+    @param scaling use cost scaling if true, successive shortest paths otherwise
+    @return the maximum flow value
+
+    Sample #1: (capacity graph, then cost graph; ans: flow 5, cost 39)
+    6 1
+    0 3 2 0 0 0
+    0 0 1 3 4 0
+    0 0 0 0 2 0
+    0 0 0 0 0 2
+    0 0 0 0 0 3
+    0 0 0 0 0 0
+    6 1
+    0 1 4 0 0 0
+    0 0 1 2 6 0
+    0 0 0 0 1 0
+    0 0 0 0 0 5
+    0 0 0 0 0 2
+    0 0 0 0 0 0
+    */
+    weight_type minCostFlow(const num_type &src, const num_type &des,
+                            const Graph *capacity, const Graph *cost,
+                            weight_type &totalCost, const bool scaling = false);
+    void testMinCostFlow(Graph *g);
+
 private:
     const num_type NOT_NODE;
     const weight_type INF;
@@ -325,6 +1183,49 @@ private:
     */
     bool isAllVisit();
 
+    /*
+    Follow the previous nodes from a node, and get the cycle met.
+
+    @param prev the previous node of each node
+    @param v the node to start from
+    @param cycle the nodes of the cycle in edge order will be stored
+                 in this field, empty if the walk ends without a cycle
+    */
+    void cycleFromPrev(const std::vector<num_type> &prev, num_type v,
+                       std::vector<num_type> &cycle);
+
+    /*
+    Yen algorithm for yen() and lazyYen().
+
+    @param in the reversed graph to bound the spur searches with,
+              nullptr to run them at once
+    */
+    void yenSearch(const CSRGraph &g, const CSRGraph *in, const num_type &src,
+                   const num_type &des, const num_type k, std::vector<Path> &res,
+                   Workspace &ws) const;
+
+    /*
+    Check if two results group the nodes into the same components.
+    */
+    bool isSamePartition(const SCCResult &a, const SCCResult &b);
+
+    /*
+    Run a parallel algorithm with 1, 2, 4, ... up to maxThreads
+    threads, and print the time of each run with its speedup over
+    the base time and its check result.
+
+    @param label printed at the start of each line
+    @param maxThreads the max threads number
+    @param base the time to compare with in ms, 0 to use the time
+                of the run with 1 thread
+    @param run runs the algorithm with the given threads number, and
+               returns true if the result is correct
+    @param rounds the time of a run is divided by this number
+    @return the base time
+    */
+    double benchmarkThreads(const char *label, const unsigned maxThreads, double base,
+                            const std::function<bool(unsigned)> &run, const unsigned rounds = 1);
+
     /*
     Get an un-visited node that has the smallest dist value.
     */
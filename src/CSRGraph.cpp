@@ -0,0 +1,104 @@
+#include "CSRGraph.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+using sl::CSRGraph;
+using sl::Graph;
+using std::vector;
+
+CSRGraph::CSRGraph(const Graph *g) : n(g->size()) {
+    vector<Graph::Edge> edges;
+    g->getEdges(edges);
+    build(edges);
+}
+
+CSRGraph::CSRGraph(const num_type &n_, const vector<Graph::Edge> &edges) : n(n_) {
+    build(edges);
+}
+
+CSRGraph::~CSRGraph() {
+}
+
+void CSRGraph::build(const vector<Graph::Edge> &edges) {
+    for (const auto &e : edges) {
+        if (e.from < 0 || e.from >= n || e.to < 0 || e.to >= n) {
+            throw std::range_error("CSRGraph.build(): node number is not valid");
+        }
+    }
+    offsets_.assign(n + 1, 0);
+    for (const auto &e : edges) {
+        ++offsets_[e.from + 1];
+    }
+    for (num_type i = 0; i < n; ++i) {
+        offsets_[i + 1] += offsets_[i];
+    }
+    targets_.resize(edges.size());
+    weights_.resize(edges.size());
+    vector<offset_type> pos(offsets_.begin(), offsets_.end() - 1);
+    for (const auto &e : edges) {
+        auto p = pos[e.from]++;
+        targets_[p] = (index_type)e.to;
+        weights_[p] = e.weight;
+    }
+}
+
+CSRGraph::num_type CSRGraph::size() const {
+    return n;
+}
+
+CSRGraph::offset_type CSRGraph::edgeCount() const {
+    return targets_.size();
+}
+
+CSRGraph::offset_type CSRGraph::degree(const num_type &v) const {
+    return offsets_[v + 1] - offsets_[v];
+}
+
+CSRGraph CSRGraph::transpose() const {
+    vector<Graph::Edge> edges;
+    edges.reserve(targets_.size());
+    for (num_type i = 0; i < n; ++i) {
+        for (auto j = offsets_[i]; j < offsets_[i + 1]; ++j) {
+            edges.push_back(Graph::Edge(targets_[j], i, weights_[j]));
+        }
+    }
+    return CSRGraph(n, edges);
+}
+
+void CSRGraph::sortNeighbours() {
+    vector<offset_type> idx;
+    vector<index_type> t;
+    vector<weight_type> w;
+    for (num_type i = 0; i < n; ++i) {
+        auto lo = offsets_[i], hi = offsets_[i + 1];
+        if (std::is_sorted(targets_.begin() + lo, targets_.begin() + hi)) {
+            continue;
+        }
+        idx.resize(hi - lo);
+        std::iota(idx.begin(), idx.end(), lo);
+        std::stable_sort(idx.begin(), idx.end(), [&](offset_type a, offset_type b) {
+            return targets_[a] < targets_[b];
+        });
+        t.clear();
+        w.clear();
+        for (const auto &k : idx) {
+            t.push_back(targets_[k]);
+            w.push_back(weights_[k]);
+        }
+        std::copy(t.begin(), t.end(), targets_.begin() + lo);
+        std::copy(w.begin(), w.end(), weights_.begin() + lo);
+    }
+}
+
+const vector<CSRGraph::offset_type>& CSRGraph::offsets() const {
+    return offsets_;
+}
+
+const vector<CSRGraph::index_type>& CSRGraph::targets() const {
+    return targets_;
+}
+
+const vector<CSRGraph::weight_type>& CSRGraph::weights() const {
+    return weights_;
+}
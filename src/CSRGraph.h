@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Base.h"
+#include "Graph.h"
+#include <vector>
+
+NS_BEGIN
+
+/*
+A read-only graph in compressed sparse row (CSR) format.
+
+The adjacent nodes of node v are stored contiguously in
+targets()[offsets()[v], offsets()[v + 1]), with the edge weights
+at the same positions of weights(). Algorithms that only read
+the graph can scan the neighbours without any allocation.
+
+Build it from a Graph (or an edge list) once, and rebuild it
+after the Graph changes.
+*/
+class CSRGraph {
+public:
+    typedef Graph::num_type num_type;
+    typedef Graph::weight_type weight_type;
+
+    // Type for node number value in the arrays
+    typedef unsigned index_type;
+
+    // Type for position in the edge arrays
+    typedef unsigned long long offset_type;
+
+    /*
+    Build from a Graph.
+    The neighbours keep the order of the Graph.
+
+    @param g the graph object
+    */
+    CSRGraph(const Graph *g);
+
+    /*
+    Build from an edge list.
+    The neighbours keep the order of the edge list.
+
+    @param n the number of nodes
+    @param edges the edges of the graph
+    */
+    CSRGraph(const num_type &n, const std::vector<Graph::Edge> &edges);
+
+    ~CSRGraph();
+
+    /*
+    Return the number of nodes.
+    */
+    num_type size() const;
+
+    /*
+    Return the number of edges.
+    */
+    offset_type edgeCount() const;
+
+    /*
+    Return the number of adjacent nodes of a node.
+    */
+    offset_type degree(const num_type &n) const;
+
+    /*
+    Return the graph with all the edges reversed.
+    */
+    CSRGraph transpose() const;
+
+    /*
+    Sort the neighbours of each node by node number.
+    */
+    void sortNeighbours();
+
+    /*
+    Return the content arrays.
+    */
+    const std::vector<offset_type>& offsets() const;
+    const std::vector<index_type>& targets() const;
+    const std::vector<weight_type>& weights() const;
+
+private:
+    num_type n;
+
+    // Size n + 1
+    std::vector<offset_type> offsets_;
+
+    // Size edgeCount()
+    std::vector<index_type> targets_;
+    std::vector<weight_type> weights_;
+
+    /*
+    Fill the arrays from an edge list. (counting sort by start node)
+    */
+    void build(const std::vector<Graph::Edge> &edges);
+};
+
+NS_END
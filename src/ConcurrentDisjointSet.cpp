@@ -0,0 +1,127 @@
+#include "ConcurrentDisjointSet.h"
+#include "DisjointSet.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "Timer.h"
+#include <cstdio>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::cin;
+using std::vector;
+using sl::ConcurrentDisjointSet;
+using sl::DisjointSet;
+using sl::Parallel;
+using sl::Random;
+using sl::Timer;
+
+ConcurrentDisjointSet::ConcurrentDisjointSet(const unsigned &size) : parent(size) {
+    for (unsigned i = 0; i < size; ++i) {
+        parent[i].store(i, std::memory_order_relaxed);
+    }
+}
+
+ConcurrentDisjointSet::~ConcurrentDisjointSet() {
+}
+
+unsigned ConcurrentDisjointSet::find(unsigned x) {
+    while (1) {
+        auto p = parent[x].load();
+        if (p == x) {
+            return x;
+        }
+        auto gp = parent[p].load();
+        if (p != gp) {
+            parent[x].compare_exchange_weak(p, gp);  // Path halving
+        }
+        x = gp;
+    }
+}
+
+bool ConcurrentDisjointSet::union_(unsigned a, unsigned b) {
+    while (1) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return false;
+        }
+        if (a > b) {
+            std::swap(a, b);
+        }
+        // Link root a under root b if a is still a root
+        unsigned expected = a;
+        if (parent[a].compare_exchange_strong(expected, b)) {
+            return true;
+        }
+    }
+}
+
+void ConcurrentDisjointSet::unionAll(const vector<edge_type> &edges, const unsigned threadNum) {
+    Parallel::forRange(0, edges.size(), [&](unsigned long long i) {
+        union_(edges[i].first, edges[i].second);
+    }, threadNum);
+}
+
+bool ConcurrentDisjointSet::sameSet(unsigned a, unsigned b) {
+    while (1) {
+        a = find(a);
+        b = find(b);
+        if (a == b) {
+            return true;
+        }
+        // If a is still a root, a and b were in different sets
+        // when b was found
+        if (parent[a].load() == a) {
+            return false;
+        }
+    }
+}
+
+unsigned ConcurrentDisjointSet::size() const {
+    return (unsigned)parent.size();
+}
+
+void ConcurrentDisjointSet::test() {
+    cout << "Test ConcurrentDisjointSet:\n" << endl;
+    cin.clear();
+    unsigned n, m, maxThreads;
+    cout << "Input elements number, edges number and max threads number: ";
+    cin >> n >> m >> maxThreads;
+    cout << endl;
+    auto random = Random::getInstance();
+    vector<edge_type> edges;
+    for (unsigned i = 0; i < m; ++i) {
+        edges.push_back(edge_type((unsigned)random->randInt(0, n - 1),
+                                  (unsigned)random->randInt(0, n - 1)));
+    }
+    Timer timer;
+    DisjointSet expected(n);
+    for (const auto &e : edges) {
+        expected.union_(e.first, e.second);
+    }
+    printf("DisjointSet:              %8.2lf ms\n", timer.elapse());
+    for (unsigned threadNum = 1; threadNum <= maxThreads; threadNum <<= 1) {
+        ConcurrentDisjointSet s(n);
+        timer.reset();
+        s.unionAll(edges, threadNum);
+        auto time = timer.elapse();
+        // Same partition iff each set maps to one representative
+        // and both have the same number of sets
+        vector<unsigned> rep(n, n);
+        unsigned sets1 = 0, sets2 = 0;
+        bool correct = true;
+        for (unsigned i = 0; i < n && correct; ++i) {
+            auto r1 = expected.find(i), r2 = s.find(i);
+            if (rep[r1] == n) {
+                rep[r1] = r2;
+            }
+            correct = rep[r1] == r2;
+            sets1 += r1 == i;
+            sets2 += r2 == i;
+        }
+        correct = correct && sets1 == sets2;
+        printf("%2u thread(s) unionAll(): %8.2lf ms, check %s\n",
+               threadNum, time, correct ? "pass" : "failed");
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Base.h"
+#include <atomic>
+#include <utility>
+#include <vector>
+
+NS_BEGIN
+
+/*
+A lock-free disjoint set data structure.
+
+All the operations can be called from different threads at
+the same time. Each element stores only its parent in an atomic
+word, and a root is an element whose parent is itself.
+
+1. find uses path halving: every node on the path is pointed
+   to its grandparent with a CAS, which may fail harmlessly.
+2. union links roots by index: the root with the smaller index
+   is linked under the other one with a CAS that only succeeds
+   if it is still a root, otherwise the union is retried.
+
+For usage, see function test().
+*/
+class ConcurrentDisjointSet {
+public:
+    typedef std::pair<unsigned, unsigned> edge_type;
+
+    ConcurrentDisjointSet(const unsigned &size);
+    ~ConcurrentDisjointSet();
+
+    /*
+    Forbid copy.
+    */
+    ConcurrentDisjointSet(const ConcurrentDisjointSet &s) = delete;
+    ConcurrentDisjointSet& operator=(const ConcurrentDisjointSet &s) = delete;
+
+    /*
+    Union two numbers to the same set.
+    (union by index)
+
+    @param a the first number
+    @param b the second number
+    @return true if the two numbers were in different sets
+    */
+    bool union_(unsigned a, unsigned b);
+
+    /*
+    Union the two numbers of each edge on multiple threads.
+
+    @param edges the pairs of numbers to union
+    @param threadNum the number of threads, 0 for all hardware threads
+    */
+    void unionAll(const std::vector<edge_type> &edges, const unsigned threadNum = 0);
+
+    /*
+    Find the set that contains the number x.
+
+    @return the set index, which may change if a concurrent
+            union links the set to another one
+    */
+    unsigned find(unsigned x);
+
+    /*
+    Check if two numbers are in the same set.
+    The answer is correct at some moment during the call.
+    */
+    bool sameSet(unsigned a, unsigned b);
+
+    /*
+    Return the size of the content array.
+    */
+    unsigned size() const;
+
+private:
+    std::vector<std::atomic<unsigned>> parent;
+
+public:
+    /*
+    Test the function of the class.
+    Union random edges with different numbers of threads,
+    and compare the sets with DisjointSet.
+
+    Sample #1:
+    1000000 2000000 4
+    */
+    static void test();
+};
+
+NS_END
@@ -0,0 +1,589 @@
+#include "ContractionHierarchy.h"
+#include "AlgorithmGraph.h"
+#include "GraphGenerator.h"
+#include "Random.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+using sl::ContractionHierarchy;
+using sl::AlgorithmGraph;
+using sl::CSRGraph;
+using sl::Graph;
+using sl::GraphGenerator;
+using sl::Random;
+using sl::Timer;
+using std::cout;
+using std::cin;
+using std::endl;
+using std::vector;
+using std::string;
+
+const ContractionHierarchy::weight_type ContractionHierarchy::INF = 2147483647;
+const ContractionHierarchy::index_type ContractionHierarchy::NO_MIDDLE;
+
+namespace {
+
+typedef ContractionHierarchy::weight_type weight_type;
+typedef ContractionHierarchy::index_type index_type;
+
+// Magic bytes at the beginning of a hierarchy file
+const char HIERARCHY_MAGIC[8] = { 'S', 'L', 'C', 'H', ' ', 'v', '1', 0 };
+
+/*
+Edge of the remaining graph during contraction.
+*/
+struct WorkArc {
+    index_type to;
+    weight_type weight;
+    index_type middle;
+
+    WorkArc(const index_type t, const weight_type w, const index_type m)
+        : to(t), weight(w), middle(m) {}
+};
+
+/*
+The remaining graph and the witness search used by preprocessing.
+*/
+class Contractor {
+public:
+    vector<vector<WorkArc>> out;
+    vector<vector<WorkArc>> in;  // in[v] holds u for each edge u->v
+
+    Contractor(const CSRGraph &g, const unsigned limit_)
+        : out(g.size()), in(g.size()), limit(limit_),
+          stamp(g.size(), 0), targetStamp(g.size(), 0), dist(g.size(), 0), generation(0) {
+        const auto &offs = g.offsets();
+        const auto &tgts = g.targets();
+        const auto &wts = g.weights();
+        for (index_type u = 0; u < (index_type)g.size(); ++u) {
+            for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+                if (tgts[j] != u) {
+                    addArc(u, tgts[j], wts[j], ContractionHierarchy::NO_MIDDLE);
+                }
+            }
+        }
+    }
+
+    /*
+    Add edge u->v, or lower the weight of the existing one.
+    */
+    void addArc(const index_type u, const index_type v, const weight_type w, const index_type middle) {
+        for (auto &a : out[u]) {
+            if (a.to == v) {
+                if (w < a.weight) {
+                    a.weight = w;
+                    a.middle = middle;
+                    for (auto &b : in[v]) {
+                        if (b.to == u) {
+                            b.weight = w;
+                            b.middle = middle;
+                            break;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out[u].push_back(WorkArc(v, w, middle));
+        in[v].push_back(WorkArc(u, w, middle));
+    }
+
+    /*
+    Find the shortcuts needed to contract node v.
+
+    @param v the node to contract
+    @param res the shortcuts (u, x, weight) will be stored in this field
+    */
+    void shortcutsOf(const index_type v, vector<std::pair<std::pair<index_type, index_type>, weight_type>> &res) {
+        res.clear();
+        weight_type maxOut = 0;
+        for (const auto &a : out[v]) {
+            maxOut = std::max(maxOut, a.weight);
+        }
+        for (const auto &ia : in[v]) {
+            witnessSearch(ia.to, v, ia.weight + maxOut, out[v].size());
+            for (const auto &oa : out[v]) {
+                if (oa.to == ia.to) {
+                    continue;
+                }
+                auto w = ia.weight + oa.weight;
+                if (stamp[oa.to] != generation || dist[oa.to] > w) {
+                    res.push_back(std::make_pair(std::make_pair(ia.to, oa.to), w));
+                }
+            }
+        }
+    }
+
+    /*
+    Remove node v from the remaining graph.
+    */
+    void remove(const index_type v) {
+        for (const auto &a : out[v]) {
+            eraseArc(in[a.to], v);
+        }
+        for (const auto &a : in[v]) {
+            eraseArc(out[a.to], v);
+        }
+        vector<WorkArc>().swap(out[v]);
+        vector<WorkArc>().swap(in[v]);
+    }
+
+private:
+    typedef std::pair<weight_type, index_type> heap_node;
+
+    unsigned limit;
+    vector<unsigned> stamp;
+    vector<unsigned> targetStamp;
+    vector<weight_type> dist;
+    unsigned generation;
+    vector<heap_node> heap;
+
+    static void eraseArc(vector<WorkArc> &arcs, const index_type v) {
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            if (arcs[i].to == v) {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+
+    /*
+    Dijkstra from src avoiding node skip, until the distance exceeds
+    bound, limit nodes are settled, or all the out-neighbours of skip
+    are settled.
+    */
+    void witnessSearch(const index_type src, const index_type skip, const weight_type bound,
+                       size_t targets) {
+        if (++generation == 0) {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            std::fill(targetStamp.begin(), targetStamp.end(), 0);
+            generation = 1;
+        }
+        for (const auto &a : out[skip]) {
+            targetStamp[a.to] = generation;
+        }
+        // Keep the heap storage between searches
+        heap.clear();
+        stamp[src] = generation;
+        dist[src] = 0;
+        heap.push_back(heap_node(0, src));
+        unsigned settled = 0;
+        while (!heap.empty() && settled < limit) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<heap_node>());
+            auto d = heap.back().first;
+            auto u = heap.back().second;
+            heap.pop_back();
+            if (d > dist[u]) {
+                continue;  // Outdated heap node
+            }
+            if (d > bound) {
+                break;
+            }
+            ++settled;
+            if (targetStamp[u] == generation && --targets == 0) {
+                break;
+            }
+            for (const auto &a : out[u]) {
+                if (a.to == skip) {
+                    continue;
+                }
+                auto nd = d + a.weight;
+                if (stamp[a.to] != generation || nd < dist[a.to]) {
+                    stamp[a.to] = generation;
+                    dist[a.to] = nd;
+                    heap.push_back(heap_node(nd, a.to));
+                    std::push_heap(heap.begin(), heap.end(), std::greater<heap_node>());
+                }
+            }
+        }
+    }
+};
+
+template <typename T>
+void writeVector(std::ofstream &out, const vector<T> &v) {
+    uint64_t size = v.size();
+    out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    out.write(reinterpret_cast<const char*>(v.data()), size * sizeof(T));
+}
+
+template <typename T>
+void readVector(std::ifstream &in, vector<T> &v, const uint64_t maxSize) {
+    uint64_t size = 0;
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!in || size > maxSize) {
+        throw std::runtime_error("ContractionHierarchy.load(): file is broken");
+    }
+    v.resize(size);
+    in.read(reinterpret_cast<char*>(v.data()), size * sizeof(T));
+}
+
+}
+
+void ContractionHierarchy::SearchState::init(const num_type n) {
+    stamp.assign(n, 0);
+    dist.assign(n, INF);
+    prev.assign(n, 0);
+    arc.assign(n, 0);
+    generation = 0;
+}
+
+void ContractionHierarchy::SearchState::reset() {
+    if (++generation == 0) {  // Wrap around, clear all stamps once
+        std::fill(stamp.begin(), stamp.end(), 0);
+        generation = 1;
+    }
+}
+
+bool ContractionHierarchy::SearchState::reached(const index_type v) const {
+    return stamp[v] == generation;
+}
+
+ContractionHierarchy::ContractionHierarchy() : n(0), shortcuts(0) {
+}
+
+ContractionHierarchy::~ContractionHierarchy() {
+}
+
+void ContractionHierarchy::build(const Graph *g, const unsigned witnessLimit) {
+    build(CSRGraph(g), witnessLimit);
+}
+
+void ContractionHierarchy::build(const CSRGraph &g, const unsigned witnessLimit) {
+    typedef std::pair<long long, index_type> heap_node;
+    n = g.size();
+    rank.assign(n, 0);
+    Contractor c(g, witnessLimit);
+    vector<long long> contractedNeighbours(n, 0), level(n, 0);
+    vector<vector<WorkArc>> upArcs(n), downArcs(n);
+    vector<std::pair<std::pair<index_type, index_type>, weight_type>> added;
+    // Edge difference, leave the shortcuts of v in added
+    auto priority = [&](const index_type v) {
+        c.shortcutsOf(v, added);
+        return 2 * ((long long)added.size() - (long long)c.in[v].size()
+            - (long long)c.out[v].size()) + contractedNeighbours[v] + level[v];
+    };
+    std::priority_queue<heap_node, vector<heap_node>, std::greater<heap_node>> q;
+    for (index_type v = 0; v < (index_type)n; ++v) {
+        q.push(heap_node(priority(v), v));
+    }
+    num_type order = 0;
+    while (!q.empty()) {
+        auto v = q.top().second;
+        q.pop();
+        // Lazy update: contract v only if it is still the best
+        auto p = priority(v);
+        if (!q.empty() && p > q.top().first) {
+            q.push(heap_node(p, v));
+            continue;
+        }
+        rank[v] = order++;
+        for (const auto &s : added) {
+            c.addArc(s.first.first, s.first.second, s.second, v);
+        }
+        upArcs[v] = c.out[v];
+        downArcs[v] = c.in[v];
+        for (const auto &a : c.out[v]) {
+            ++contractedNeighbours[a.to];
+            level[a.to] = std::max(level[a.to], level[v] + 1);
+        }
+        for (const auto &a : c.in[v]) {
+            ++contractedNeighbours[a.to];
+            level[a.to] = std::max(level[a.to], level[v] + 1);
+        }
+        c.remove(v);
+    }
+    shortcuts = 0;
+    Arcs *arcs[2] = { &up, &down };
+    vector<vector<WorkArc>> *lists[2] = { &upArcs, &downArcs };
+    for (int k = 0; k < 2; ++k) {
+        auto &a = *arcs[k];
+        a.offsets.assign(1, 0);
+        a.targets.clear();
+        a.weights.clear();
+        a.middles.clear();
+        for (const auto &list : *lists[k]) {
+            for (const auto &e : list) {
+                a.targets.push_back(e.to);
+                a.weights.push_back(e.weight);
+                a.middles.push_back(e.middle);
+                shortcuts += e.middle != NO_MIDDLE;
+            }
+            a.offsets.push_back(a.targets.size());
+        }
+    }
+    forward.init(n);
+    backward.init(n);
+}
+
+ContractionHierarchy::num_type ContractionHierarchy::size() const {
+    return n;
+}
+
+ContractionHierarchy::offset_type ContractionHierarchy::shortcutCount() const {
+    return shortcuts;
+}
+
+ContractionHierarchy::num_type ContractionHierarchy::rankOf(const num_type &v) const {
+    checkValid(v);
+    return rank[v];
+}
+
+void ContractionHierarchy::checkValid(const num_type &v) const {
+    if (v < 0 || v >= n) {
+        throw std::range_error("ContractionHierarchy.checkValid(): node number is not valid");
+    }
+}
+
+ContractionHierarchy::offset_type ContractionHierarchy::findArc(const Arcs &arcs, const index_type v,
+                                                                const index_type u) {
+    for (auto j = arcs.offsets[v]; j < arcs.offsets[v + 1]; ++j) {
+        if (arcs.targets[j] == u) {
+            return j;
+        }
+    }
+    throw std::range_error("ContractionHierarchy.findArc(): hierarchy is broken");
+}
+
+void ContractionHierarchy::unpack(const index_type a, const index_type b, const index_type middle,
+                                  vector<num_type> &path) const {
+    struct Segment {
+        index_type a, b, middle;
+    };
+    vector<Segment> stack(1, Segment{ a, b, middle });
+    while (!stack.empty()) {
+        auto s = stack.back();
+        stack.pop_back();
+        if (s.middle == NO_MIDDLE) {
+            path.push_back(s.b);
+            continue;
+        }
+        // The middle node is ranked lower than both ends: a->middle is
+        // in its downward edges and middle->b in its upward edges
+        auto j1 = findArc(down, s.middle, s.a);
+        auto j2 = findArc(up, s.middle, s.b);
+        stack.push_back(Segment{ s.middle, s.b, up.middles[j2] });
+        stack.push_back(Segment{ s.a, s.middle, down.middles[j1] });
+    }
+}
+
+ContractionHierarchy::Route ContractionHierarchy::query(const num_type &src, const num_type &des) {
+    typedef std::pair<weight_type, index_type> heap_node;
+    typedef std::priority_queue<heap_node, vector<heap_node>, std::greater<heap_node>> heap_type;
+    checkValid(src);
+    checkValid(des);
+    Route res;
+    res.dist = INF;
+    res.settled = 0;
+    forward.reset();
+    backward.reset();
+    auto s = (index_type)src, t = (index_type)des;
+    forward.stamp[s] = forward.generation;
+    forward.dist[s] = 0;
+    forward.prev[s] = s;
+    backward.stamp[t] = backward.generation;
+    backward.dist[t] = 0;
+    backward.prev[t] = t;
+    index_type meet = s;
+    heap_type qf, qb;
+    qf.push(heap_node(0, s));
+    qb.push(heap_node(0, t));
+    while (!qf.empty() || !qb.empty()) {
+        bool isForward = qb.empty() || (!qf.empty() && qf.top().first <= qb.top().first);
+        auto &q = isForward ? qf : qb;
+        auto &self = isForward ? forward : backward;
+        const auto &other = isForward ? backward : forward;
+        const auto &arcs = isForward ? up : down;
+        const auto &opposite = isForward ? down : up;
+        auto d = q.top().first;
+        auto u = q.top().second;
+        q.pop();
+        if (d > self.dist[u]) {
+            continue;  // Outdated heap node
+        }
+        if (d >= res.dist) {
+            q = heap_type();  // This side can not improve the path
+            continue;
+        }
+        ++res.settled;
+        if (other.reached(u) && d + other.dist[u] < res.dist) {
+            res.dist = d + other.dist[u];
+            meet = u;
+        }
+        // Stall on demand: u is not reached optimally if a higher
+        // ranked node has a shorter path to it
+        bool stalled = false;
+        for (auto j = opposite.offsets[u]; j < opposite.offsets[u + 1]; ++j) {
+            auto x = opposite.targets[j];
+            if (self.reached(x) && self.dist[x] + opposite.weights[j] < d) {
+                stalled = true;
+                break;
+            }
+        }
+        if (stalled) {
+            continue;
+        }
+        for (auto j = arcs.offsets[u]; j < arcs.offsets[u + 1]; ++j) {
+            auto v = arcs.targets[j];
+            auto nd = d + arcs.weights[j];
+            if (!self.reached(v) || nd < self.dist[v]) {
+                self.stamp[v] = self.generation;
+                self.dist[v] = nd;
+                self.prev[v] = u;
+                self.arc[v] = j;
+                q.push(heap_node(nd, v));
+            }
+        }
+    }
+    if (res.dist < INF) {
+        vector<index_type> upPath;
+        for (auto v = meet; v != s; v = forward.prev[v]) {
+            upPath.push_back(v);
+        }
+        res.path.push_back(s);
+        for (auto i = upPath.size(); i > 0; --i) {
+            auto v = upPath[i - 1];
+            unpack(forward.prev[v], v, up.middles[forward.arc[v]], res.path);
+        }
+        for (auto v = meet; v != t; v = backward.prev[v]) {
+            unpack(v, backward.prev[v], down.middles[backward.arc[v]], res.path);
+        }
+    }
+    return res;
+}
+
+void ContractionHierarchy::save(const string &file) const {
+    std::ofstream out(file, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("ContractionHierarchy.save(): can not open file");
+    }
+    vector<int64_t> ranks(rank.begin(), rank.end());
+    out.write(HIERARCHY_MAGIC, sizeof(HIERARCHY_MAGIC));
+    writeVector(out, ranks);
+    const Arcs *arcs[2] = { &up, &down };
+    for (auto a : arcs) {
+        writeVector(out, a->offsets);
+        writeVector(out, a->targets);
+        writeVector(out, a->weights);
+        writeVector(out, a->middles);
+    }
+    if (!out) {
+        throw std::runtime_error("ContractionHierarchy.save(): write failed");
+    }
+}
+
+void ContractionHierarchy::load(const string &file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("ContractionHierarchy.load(): can not open file");
+    }
+    char magic[sizeof(HIERARCHY_MAGIC)];
+    in.read(magic, sizeof(magic));
+    if (!in || memcmp(magic, HIERARCHY_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error("ContractionHierarchy.load(): not a hierarchy file");
+    }
+    const uint64_t maxSize = 1ULL << 40;
+    vector<int64_t> ranks;
+    readVector(in, ranks, maxSize);
+    Arcs arcs[2];
+    for (auto &a : arcs) {
+        readVector(in, a.offsets, ranks.size() + 1);
+        readVector(in, a.targets, maxSize);
+        readVector(in, a.weights, a.targets.size());
+        readVector(in, a.middles, a.targets.size());
+        if (!in || a.offsets.size() != ranks.size() + 1 || a.offsets.back() != a.targets.size()
+            || a.weights.size() != a.targets.size() || a.middles.size() != a.targets.size()) {
+            throw std::runtime_error("ContractionHierarchy.load(): file is broken");
+        }
+    }
+    // Every id read is used as an index by queries and path unpacking
+    const uint64_t count = ranks.size();
+    for (const auto &r : ranks) {
+        if (r < 0 || (uint64_t)r >= count) {
+            throw std::range_error("ContractionHierarchy.load(): rank is out of range");
+        }
+    }
+    for (const auto &a : arcs) {
+        for (uint64_t v = 0; v < count; ++v) {
+            if (a.offsets[v] > a.offsets[v + 1]) {
+                throw std::range_error("ContractionHierarchy.load(): arc offsets are not ordered");
+            }
+        }
+        for (uint64_t j = 0; j < a.targets.size(); ++j) {
+            if (a.targets[j] >= count || (a.middles[j] != NO_MIDDLE && a.middles[j] >= count)) {
+                throw std::range_error("ContractionHierarchy.load(): node is out of range");
+            }
+        }
+    }
+    n = ranks.size();
+    rank.assign(ranks.begin(), ranks.end());
+    up = std::move(arcs[0]);
+    down = std::move(arcs[1]);
+    shortcuts = 0;
+    for (const auto &a : { &up, &down }) {
+        for (auto m : a->middles) {
+            shortcuts += m != NO_MIDDLE;
+        }
+    }
+    forward.init(n);
+    backward.init(n);
+}
+
+void ContractionHierarchy::test() {
+    cout << "Test ContractionHierarchy:\n\n";
+    cin.clear();
+    Graph::num_type side;
+    unsigned queries;
+    cout << "Input grid side length and queries number: ";
+    cin >> side >> queries;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::grid(side, side, 1, 100, edges);
+    CSRGraph csr(side * side, edges);
+    ContractionHierarchy ch;
+    Timer timer;
+    ch.build(csr);
+    printf("Preprocess: %.2lf ms, %llu edges, %llu shortcuts\n",
+           timer.elapse(), csr.edgeCount(), ch.shortcutCount());
+    const string file = "hierarchy.bin";
+    ch.save(file);
+    ContractionHierarchy loaded;
+    timer.reset();
+    loaded.load(file);
+    printf("Load from file: %.2lf ms\n", timer.elapse());
+    std::remove(file.c_str());
+    auto algorithmGraph = AlgorithmGraph::getInstance();
+    auto random = Random::getInstance();
+    double time[2] = { 0, 0 };
+    unsigned long long settled[2] = { 0, 0 };
+    bool correct = true;
+    for (unsigned i = 0; i < queries; ++i) {
+        auto s = (num_type)random->randInt(0, csr.size() - 1);
+        auto t = (num_type)random->randInt(0, csr.size() - 1);
+        timer.reset();
+        auto expected = algorithmGraph->dijkstra(csr, s);
+        time[0] += timer.elapse();
+        settled[0] += csr.size();
+        timer.reset();
+        auto r = loaded.query(s, t);
+        time[1] += timer.elapse();
+        settled[1] += r.settled;
+        correct = correct && r.dist == expected.dist[t]
+            && r.path.front() == s && r.path.back() == t;
+    }
+    const char *names[2] = { "dijkstra", "CH" };
+    for (int i = 0; i < 2; ++i) {
+        printf("%10s: %8.3lf ms/query, %10.1lf nodes settled/query\n", names[i],
+               time[i] / queries, (double)settled[i] / queries);
+    }
+    printf("Check: %s\n", correct ? "pass" : "failed");
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "Base.h"
+#include "CSRGraph.h"
+#include "Graph.h"
+#include "PointToPointQuery.h"
+#include <string>
+#include <vector>
+
+NS_BEGIN
+
+/*
+Contraction hierarchies for shortest path queries on a static graph.
+
+Preprocessing contracts the nodes one by one in order of importance.
+Contracting node v removes it from the remaining graph, and adds a
+shortcut u->x (weight w(u,v) + w(v,x)) for each pair of neighbours
+whose shortest path goes through v. A witness search (a Dijkstra
+from u that avoids v, limited in the number of settled nodes) skips
+the shortcuts that are not needed. The next node to contract is the
+one with the smallest priority:
+    2 * (shortcuts added - edges removed) + contracted neighbours + level
+where the level of a node is one more than that of its deepest
+contracted neighbour, so the nodes are contracted evenly over the
+graph. The priorities are kept up to date lazily in a heap.
+
+The rank of a node is the order of its contraction. Every shortest
+path then has an equivalent path which goes up in rank and then
+down, so a query only runs two small upward searches: forward from
+the source on the upward graph, and backward from the target on
+the reversed downward graph. Both graphs are kept in CSR form, and
+shortcuts remember the contracted node in the middle, so that the
+path is unpacked into original edges.
+
+The preprocessed hierarchy can be saved to and loaded from a
+binary file, the original graph is not needed for queries.
+
+Edge weights must be nonnegative. An object can run one query at
+a time; use one object per thread.
+
+For usage, see function test().
+*/
+class ContractionHierarchy {
+public:
+    typedef CSRGraph::num_type num_type;
+    typedef CSRGraph::weight_type weight_type;
+    typedef CSRGraph::index_type index_type;
+    typedef CSRGraph::offset_type offset_type;
+    typedef PointToPointQuery::Route Route;
+
+    // Distance of an unreachable node
+    static const weight_type INF;
+
+    // Middle node of an original edge
+    static const index_type NO_MIDDLE = (index_type)-1;
+
+    ContractionHierarchy();
+    ~ContractionHierarchy();
+
+    /*
+    Preprocess a graph.
+    (time complexity depends on the graph, fast for road-like graphs)
+
+    @param g the graph
+    @param witnessLimit max nodes settled by a witness search, a shortcut
+           is added when the search stops before finding a witness
+    */
+    void build(const CSRGraph &g, const unsigned witnessLimit = 100);
+    void build(const Graph *g, const unsigned witnessLimit = 100);
+
+    /*
+    Query the shortest path between two nodes.
+
+    @param src the source node
+    @param des the target node
+    */
+    Route query(const num_type &src, const num_type &des);
+
+    /*
+    Return the number of nodes.
+    */
+    num_type size() const;
+
+    /*
+    Return the number of shortcuts added by preprocessing.
+    */
+    offset_type shortcutCount() const;
+
+    /*
+    Return the contraction order of a node, 0 for the first contracted.
+    */
+    num_type rankOf(const num_type &v) const;
+
+    /*
+    Save the hierarchy to a binary file.
+
+    @param file the file path
+    @throw std::runtime_error if the file can not be written
+    */
+    void save(const std::string &file) const;
+
+    /*
+    Load a hierarchy from a binary file.
+
+    @param file the file path
+    @throw std::runtime_error if the file can not be read
+    @throw std::range_error if a node, rank or offset in the file is out of range
+    */
+    void load(const std::string &file);
+
+private:
+    /*
+    Edges to higher ranked nodes in CSR form.
+    For the downward graph, the edges are reversed.
+    */
+    struct Arcs {
+        std::vector<offset_type> offsets;
+        std::vector<index_type> targets;
+        std::vector<weight_type> weights;
+        std::vector<index_type> middles;  // NO_MIDDLE for original edges
+    };
+
+    /*
+    Per-node state of one search direction.
+    An entry is valid only if stamp[v] == generation.
+    */
+    struct SearchState {
+        std::vector<unsigned> stamp;
+        std::vector<weight_type> dist;
+        std::vector<index_type> prev;
+        std::vector<offset_type> arc;  // Position of the edge from prev
+        unsigned generation;
+
+        void init(const num_type n);
+        void reset();
+        bool reached(const index_type v) const;
+    };
+
+    num_type n;
+    offset_type shortcuts;
+    std::vector<num_type> rank;
+    Arcs up;
+    Arcs down;
+
+    SearchState forward;
+    SearchState backward;
+
+    /*
+    Check if the node number is valid in the hierarchy.
+
+    @throw std::range_error if the node is not valid
+    */
+    void checkValid(const num_type &v) const;
+
+    /*
+    Return the position of the edge from node u in arcs of node v.
+    */
+    static offset_type findArc(const Arcs &arcs, const index_type v, const index_type u);
+
+    /*
+    Append the original nodes of edge a->b after a to the path.
+
+    @param a the start of the edge
+    @param b the end of the edge
+    @param middle the middle node of the edge
+    @param path the nodes will be appended to this field
+    */
+    void unpack(const index_type a, const index_type b, const index_type middle,
+                std::vector<num_type> &path) const;
+
+public:
+    /*
+    Test the function of the class.
+    Preprocess a generated road-like graph, then run random queries
+    and compare the answers with a full dijkstra.
+
+    Sample #1:
+    200 1000
+    */
+    static void test();
+};
+
+NS_END
@@ -1,66 +1,110 @@
 #include "DisjointSet.h"
 #include <iostream>
+#include <stdexcept>
 
 using std::cout;
 using std::endl;
 using std::cin;
-using sl::DisjointSet;
+using sl::BasicDisjointSet;
 
-DisjointSet::DisjointSet(const unsigned &size) : arr(size, -1) {
+template <typename Index>
+BasicDisjointSet<Index>::BasicDisjointSet(const Index &size) {
+    if (size >= ROOT_BIT) {  // A set of ROOT_BIT elements would clear its root flag
+        throw std::range_error("DisjointSet(): too many elements for the index type");
+    }
+    arr.assign(size, ROOT_BIT | 1);
 }
 
-DisjointSet::~DisjointSet() { 
+template <typename Index>
+BasicDisjointSet<Index>::~BasicDisjointSet() {
 }
 
-unsigned DisjointSet::find(const unsigned &x) {
-    return arr[x] < 0 ? x : arr[x] = find(arr[x]);
+template <typename Index>
+bool BasicDisjointSet<Index>::isRoot(const Index &w) {
+    return (w & ROOT_BIT) != 0;
 }
 
-void DisjointSet::union_(const unsigned &a, const unsigned &b) {
-    int root1 = find(a);
-    int root2 = find(b);
-    if (root1 != root2) {
-        if (arr[root2] < arr[root1]) {
-            arr[root2] += arr[root1];  // Update size
-            arr[root1] = root2;
-        } else {
-            arr[root1] += arr[root2];  // Update size
-            arr[root2] = root1;
+template <typename Index>
+Index BasicDisjointSet<Index>::find(Index x) {
+    while (!isRoot(arr[x])) {
+        Index p = arr[x];
+        if (isRoot(arr[p])) {
+            return p;
         }
+        arr[x] = arr[p];  // Path halving
+        x = arr[p];
+    }
+    return x;
+}
+
+template <typename Index>
+bool BasicDisjointSet<Index>::union_(const Index &a, const Index &b) {
+    Index root1 = find(a);
+    Index root2 = find(b);
+    if (root1 == root2) {
+        return false;
+    }
+    if ((arr[root1] & ~ROOT_BIT) < (arr[root2] & ~ROOT_BIT)) {
+        arr[root2] += arr[root1] & ~ROOT_BIT;  // Update size
+        arr[root1] = root2;
+    } else {
+        arr[root1] += arr[root2] & ~ROOT_BIT;  // Update size
+        arr[root2] = root1;
     }
+    return true;
 }
 
-int& DisjointSet::operator[](const unsigned &i) {
+template <typename Index>
+Index BasicDisjointSet<Index>::setSize(const Index &x) {
+    return arr[find(x)] & ~ROOT_BIT;
+}
+
+template <typename Index>
+Index& BasicDisjointSet<Index>::operator[](const Index &i) {
     return arr[i];
 }
 
-const int& DisjointSet::operator[](const unsigned &i) const {
+template <typename Index>
+const Index& BasicDisjointSet<Index>::operator[](const Index &i) const {
     return arr[i];
 }
 
-unsigned DisjointSet::size() const {
-    return (unsigned)arr.size();
+template <typename Index>
+Index BasicDisjointSet<Index>::size() const {
+    return (Index)arr.size();
 }
 
-void DisjointSet::test() {
+template <typename Index>
+void BasicDisjointSet<Index>::test() {
     cout << "Test DisjointSet:\n" << endl;
     cin.clear();
-    DisjointSet s(10);
+    BasicDisjointSet<Index> s(10);
     while (true) {
         cout << "Input two numbers you want to add to the same set: (-1 to end)\n";
-        int a, b;
+        long long a, b;
         cin >> a >> b;
         if (a == -1 || b == -1) break;
-        s.union_(a, b);
+        s.union_((Index)a, (Index)b);
     }
+    auto print = [&](const Index &i) {
+        if (isRoot(s[i])) {
+            cout << "Array[" << i << "] = root (set size: " << s.setSize(i) << ")";
+        } else {
+            cout << "Array[" << i << "] = " << s[i];
+        }
+    };
     cout << "\nBefore path compression:\n";
-    for (unsigned i = 0; i < s.size(); ++i) {
-        cout << "Array[" << i << "] = " << s[i];
+    for (Index i = 0; i < s.size(); ++i) {
+        print(i);
         cout << " / Root of vertex " << i << ": " << s.find(i) << endl;
     }
     cout << "\nAfter path compression:\n";
-    for (unsigned i = 0; i < s.size(); ++i) {
-        cout << "Array[" << i << "] = " << s[i];
+    for (Index i = 0; i < s.size(); ++i) {
+        print(i);
         cout << " / Root of vertex " << i << ": " << s.find(i) << endl;
     }
 }
+
+// Supported index types
+template class sl::BasicDisjointSet<uint32_t>;
+template class sl::BasicDisjointSet<uint64_t>;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Base.h"
+#include <cstdint>
 #include <vector>
 
 NS_BEGIN
@@ -8,12 +9,31 @@ NS_BEGIN
 /*
 A disjoint set data structure.
 
+Template arguments:
+1. Index: the type of the element numbers, uint32_t or uint64_t.
+
+Each element takes one word of type Index. The highest bit of
+the word marks a root, and the other bits store the parent of
+a non-root element or the size of the set of a root element.
+So at most 2^31 (uint32_t) or 2^63 (uint64_t) elements are allowed.
+
+Use DisjointSet (uint32_t) or DisjointSet64 (uint64_t).
+
 For usage, see function test().
 */
-class DisjointSet {
+template <typename Index>
+class BasicDisjointSet {
 public:
-    DisjointSet(const unsigned &size);
-    ~DisjointSet();
+    typedef Index index_type;
+
+    /*
+    Initialize the set with each element in its own set.
+
+    @param size the number of elements
+    @throw std::range_error if size is not below the highest bit of Index
+    */
+    BasicDisjointSet(const Index &size);
+    ~BasicDisjointSet();
 
     /*
     Union two numbers to the same set.
@@ -21,29 +41,45 @@ public:
 
     @param a the first number
     @param b the second number
+    @return true if the two numbers were in different sets
     */
-    void union_(const unsigned &a, const unsigned &b);
+    bool union_(const Index &a, const Index &b);
 
     /*
     Find the set that contains the number x.
+    (iterative, with path halving)
 
     @return the set index
     */
-    unsigned find(const unsigned &x);
+    Index find(Index x);
+
+    /*
+    Return the size of the set that contains the number x.
+    */
+    Index setSize(const Index &x);
 
     /*
     Overloading operator []
+    Return the raw word of an element.
     */
-    int& operator[](const unsigned &i);
-    const int& operator[](const unsigned &i) const;
+    Index& operator[](const Index &i);
+    const Index& operator[](const Index &i) const;
 
     /*
     Return the size of the content array.
     */
-    unsigned size() const;
+    Index size() const;
+
+    /*
+    Check if a raw word marks a root.
+    */
+    static bool isRoot(const Index &w);
 
 private:
-    std::vector<int> arr;
+    // The highest bit of Index
+    static const Index ROOT_BIT = Index(1) << (sizeof(Index) * 8 - 1);
+
+    std::vector<Index> arr;
 
 public:
     /*
@@ -62,4 +98,7 @@ public:
     static void test();
 };
 
+typedef BasicDisjointSet<uint32_t> DisjointSet;
+typedef BasicDisjointSet<uint64_t> DisjointSet64;
+
 NS_END
@@ -0,0 +1,171 @@
+#include "DynamicConnectivity.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+using std::cout;
+using std::endl;
+using std::cin;
+using std::string;
+using std::vector;
+using sl::DynamicConnectivity;
+using sl::RollbackDisjointSet;
+
+DynamicConnectivity::DynamicConnectivity(const unsigned &n_) : n(n_) {
+}
+
+DynamicConnectivity::~DynamicConnectivity() {
+}
+
+void DynamicConnectivity::addEdge(const unsigned &a, const unsigned &b) {
+    if (a >= n || b >= n) {
+        throw std::range_error("DynamicConnectivity.addEdge(): node number is not valid");
+    }
+    ops.push_back(Operation{ ADD, std::min(a, b), std::max(a, b) });
+}
+
+void DynamicConnectivity::removeEdge(const unsigned &a, const unsigned &b) {
+    if (a >= n || b >= n) {
+        throw std::range_error("DynamicConnectivity.removeEdge(): node number is not valid");
+    }
+    ops.push_back(Operation{ REMOVE, std::min(a, b), std::max(a, b) });
+}
+
+void DynamicConnectivity::queryConnected(const unsigned &a, const unsigned &b) {
+    if (a >= n || b >= n) {
+        throw std::range_error("DynamicConnectivity.queryConnected(): node number is not valid");
+    }
+    ops.push_back(Operation{ CONNECTED, a, b });
+}
+
+void DynamicConnectivity::queryComponents() {
+    ops.push_back(Operation{ COMPONENTS, 0, 0 });
+}
+
+void DynamicConnectivity::solve(vector<unsigned> &res) {
+    res.clear();
+    unsigned m = (unsigned)ops.size();
+    if (m == 0) {
+        return;
+    }
+    tree.assign(4 * m, vector<edge_type>());
+    // Match each deletion with the latest insertion of the same edge
+    std::map<edge_type, vector<unsigned>> addTime;
+    vector<unsigned> queryId(m, 0);
+    unsigned queryCnt = 0;
+    for (unsigned i = 0; i < m; ++i) {
+        const auto &op = ops[i];
+        edge_type e(op.a, op.b);
+        switch (op.type) {
+            case ADD:
+                addTime[e].push_back(i);
+                break;
+            case REMOVE: {
+                auto it = addTime.find(e);
+                if (it == addTime.end() || it->second.empty()) {
+                    tree.clear();
+                    throw std::range_error("DynamicConnectivity.solve(): removed edge does not exist");
+                }
+                addToTree(1, 0, m, it->second.back(), i, e);
+                it->second.pop_back();
+                break;
+            }
+            default:
+                queryId[i] = queryCnt++;
+                break;
+        }
+    }
+    // Edges never deleted are alive until the end
+    for (const auto &p : addTime) {
+        for (const auto &t : p.second) {
+            addToTree(1, 0, m, t, m, p.first);
+        }
+    }
+    res.assign(queryCnt, 0);
+    RollbackDisjointSet s(n);
+    walk(1, 0, m, s, res, queryId);
+    tree.clear();
+}
+
+void DynamicConnectivity::addToTree(const unsigned node, const unsigned lo, const unsigned hi,
+                                    const unsigned l, const unsigned r, const edge_type &e) {
+    if (r <= lo || hi <= l) {
+        return;
+    }
+    if (l <= lo && hi <= r) {
+        tree[node].push_back(e);
+        return;
+    }
+    unsigned mid = lo + (hi - lo) / 2;
+    addToTree(2 * node, lo, mid, l, r, e);
+    addToTree(2 * node + 1, mid, hi, l, r, e);
+}
+
+void DynamicConnectivity::walk(const unsigned node, const unsigned lo, const unsigned hi,
+                               RollbackDisjointSet &s, vector<unsigned> &res,
+                               const vector<unsigned> &queryId) {
+    auto snap = s.snapshot();
+    for (const auto &e : tree[node]) {
+        s.union_(e.first, e.second);
+    }
+    if (hi - lo == 1) {
+        const auto &op = ops[lo];
+        if (op.type == CONNECTED) {
+            res[queryId[lo]] = s.find(op.a) == s.find(op.b) ? 1 : 0;
+        } else if (op.type == COMPONENTS) {
+            res[queryId[lo]] = s.setCount();
+        }
+    } else {
+        unsigned mid = lo + (hi - lo) / 2;
+        walk(2 * node, lo, mid, s, res, queryId);
+        walk(2 * node + 1, mid, hi, s, res, queryId);
+    }
+    s.rollback(snap);
+}
+
+void DynamicConnectivity::test() {
+    cout << "Test DynamicConnectivity:\n" << endl;
+    cin.clear();
+    cout << "Input nodes number: ";
+    unsigned n;
+    cin >> n;
+    DynamicConnectivity dc(n);
+    string oper;
+    cout << "Operations available:\n"
+        << "1. add a b (add edge (a, b))\n"
+        << "2. r a b   (remove edge (a, b))\n"
+        << "3. c a b   (query whether a and b are connected)\n"
+        << "4. n       (query the number of components)\n"
+        << "5. solve   (answer all queries and exit)\n"
+        << endl;
+    while (1) {
+        cout << "Input operation: ";
+        cin >> oper;
+        unsigned a, b;
+        if (oper == "add") {
+            cin >> a >> b;
+            dc.addEdge(a, b);
+        } else if (oper == "r") {
+            cin >> a >> b;
+            dc.removeEdge(a, b);
+        } else if (oper == "c") {
+            cin >> a >> b;
+            dc.queryConnected(a, b);
+        } else if (oper == "n") {
+            dc.queryComponents();
+        } else if (oper == "solve") {
+            vector<unsigned> res;
+            dc.solve(res);
+            cout << "Answers: ";
+            for (const auto &r : res) {
+                cout << r << " ";
+            }
+            cout << endl;
+            break;
+        } else {
+            cout << "Invalid operation." << endl;
+        }
+    }
+}
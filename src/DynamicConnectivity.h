@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Base.h"
+#include "RollbackDisjointSet.h"
+#include <utility>
+#include <vector>
+
+NS_BEGIN
+
+/*
+Offline dynamic connectivity for an undirected graph.
+
+Record a sequence of edge insertions, edge deletions and
+queries, then answer all the queries at once with solve().
+
+Each edge is alive during an interval of operations. The
+intervals are put on a segment tree over the operations, and
+a depth-first walk of the tree unions the edges of a tree node
+on entry and rolls them back on exit with RollbackDisjointSet.
+At a leaf, the union-find holds exactly the edges alive at that
+time. (time complexity: O(M * logM * logN) for M operations)
+
+For usage, see function test().
+*/
+class DynamicConnectivity {
+public:
+    /*
+    Initialize with a graph with no edges.
+
+    @param n the number of nodes
+    */
+    DynamicConnectivity(const unsigned &n);
+    ~DynamicConnectivity();
+
+    /*
+    Insert an undirected edge. Parallel edges are allowed.
+    */
+    void addEdge(const unsigned &a, const unsigned &b);
+
+    /*
+    Delete an undirected edge inserted before.
+
+    @throw std::range_error if the edge does not exist
+    */
+    void removeEdge(const unsigned &a, const unsigned &b);
+
+    /*
+    Query whether two nodes are connected.
+    The answer is 1 if connected, 0 otherwise.
+    */
+    void queryConnected(const unsigned &a, const unsigned &b);
+
+    /*
+    Query the number of connected components.
+    */
+    void queryComponents();
+
+    /*
+    Answer all the queries.
+
+    @param res the answers will be stored in this field
+               in the order of the queries
+    */
+    void solve(std::vector<unsigned> &res);
+
+private:
+    typedef std::pair<unsigned, unsigned> edge_type;
+
+    /*
+    Definition of a recorded operation.
+    */
+    enum OperType {
+        ADD,
+        REMOVE,
+        CONNECTED,
+        COMPONENTS
+    };
+
+    struct Operation {
+        OperType type;
+        unsigned a;
+        unsigned b;
+    };
+
+    unsigned n;
+
+    std::vector<Operation> ops;
+
+    /*
+    Edges on each segment tree node.
+    Node 1 is the root, node i has children 2i and 2i+1.
+    */
+    std::vector<std::vector<edge_type>> tree;
+
+    /*
+    Add an edge alive in operations [l, r) to the segment tree.
+    */
+    void addToTree(const unsigned node, const unsigned lo, const unsigned hi,
+                   const unsigned l, const unsigned r, const edge_type &e);
+
+    /*
+    Walk the segment tree and answer the queries in [lo, hi).
+    */
+    void walk(const unsigned node, const unsigned lo, const unsigned hi,
+              RollbackDisjointSet &s, std::vector<unsigned> &res,
+              const std::vector<unsigned> &queryId);
+
+public:
+    /*
+    Test the function of the class.
+
+    Sample #1:
+    5
+    add 0 1
+    add 1 2
+    c 0 2
+    n
+    r 0 1
+    c 0 2
+    n
+    add 3 4
+    add 2 3
+    c 1 4
+    n
+    solve
+
+    Answer #1:
+    1 3 0 4 1 2
+    */
+    static void test();
+};
+
+NS_END
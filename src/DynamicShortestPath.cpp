@@ -0,0 +1,284 @@
+#include "DynamicShortestPath.h"
+#include "AlgorithmGraph.h"
+#include "GraphGenerator.h"
+#include "Random.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+using sl::DynamicShortestPath;
+using sl::AlgorithmGraph;
+using sl::Graph;
+using sl::GraphGenerator;
+using sl::Random;
+using sl::Timer;
+using std::cout;
+using std::cin;
+using std::endl;
+using std::vector;
+
+const DynamicShortestPath::weight_type DynamicShortestPath::INF = 2147483647;
+const DynamicShortestPath::num_type DynamicShortestPath::NOT_NODE = -1;
+
+DynamicShortestPath::DynamicShortestPath(Graph &g_, const num_type &src_)
+    : g(g_), src(src_), generation(0) {
+    checkValid(src);
+    vector<Graph::Edge> edges;
+    g.getEdges(edges);
+    for (const auto &e : edges) {
+        if (e.weight < 0) {
+            throw std::range_error("DynamicShortestPath(): edge weight is negative");
+        }
+    }
+    const num_type n = g.size();
+    dist.assign(n, INF);
+    prev.assign(n, NOT_NODE);
+    affected.assign(n, 0);
+    dist[src] = 0;
+    heap.push_back(heap_node(0, src));
+    propagate();
+}
+
+void DynamicShortestPath::checkValid(const num_type &n) const {
+    if (!g.isValid(n)) {
+        throw std::range_error("DynamicShortestPath.checkValid(): node number is not valid");
+    }
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::setWeight(const num_type &from, const num_type &to,
+                                                             const weight_type &w) {
+    checkValid(from);
+    checkValid(to);
+    if (w < 0) {
+        throw std::range_error("DynamicShortestPath.setWeight(): weight is negative");
+    }
+    auto old = g.getWeight(from, to);
+    if (isZero(w)) {
+        return removeEdge(from, to);
+    }
+    if (isZero(old)) {
+        g.addEdge(from, to, w);
+        return decrease(from, to);
+    }
+    g.setWeight(from, to, w);
+    if (w < old) {
+        return decrease(from, to);
+    } else if (w > old) {
+        return increase(from, to);
+    }
+    return 0;
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::addEdge(const num_type &from, const num_type &to,
+                                                           const weight_type &w) {
+    return setWeight(from, to, w);
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::removeEdge(const num_type &from, const num_type &to) {
+    checkValid(from);
+    checkValid(to);
+    if (isZero(g.getWeight(from, to))) {
+        return 0;
+    }
+    g.removeEdge(from, to);
+    return increase(from, to);
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::getSource() const {
+    return src;
+}
+
+DynamicShortestPath::weight_type DynamicShortestPath::getDist(const num_type &v) const {
+    checkValid(v);
+    return dist[v];
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::getPrev(const num_type &v) const {
+    checkValid(v);
+    return prev[v];
+}
+
+void DynamicShortestPath::getPath(const num_type &des, vector<num_type> &path) const {
+    checkValid(des);
+    path.clear();
+    if (dist[des] >= INF) {
+        return;
+    }
+    for (auto v = des; v != NOT_NODE; v = prev[v]) {
+        path.push_back(v);
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+bool DynamicShortestPath::isAffected(const num_type &v) const {
+    return affected[v] == generation;
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::propagate() {
+    std::greater<heap_node> cmp;
+    std::make_heap(heap.begin(), heap.end(), cmp);
+    num_type settled = 0;
+    while (!heap.empty()) {
+        auto top = heap.front();
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        heap.pop_back();
+        auto u = top.second;
+        if (top.first > dist[u]) {
+            continue;  // Outdated heap node
+        }
+        ++settled;
+        g.getNeighbours(u, adjs);
+        for (const auto &v : adjs) {
+            auto d = dist[u] + g.getWeight(u, v);
+            if (d < dist[v]) {
+                dist[v] = d;
+                prev[v] = u;
+                heap.push_back(heap_node(d, v));
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+    return settled;
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::decrease(const num_type &u, const num_type &v) {
+    if (dist[u] >= INF) {
+        return 0;
+    }
+    auto d = dist[u] + g.getWeight(u, v);
+    if (d >= dist[v]) {
+        return 0;
+    }
+    dist[v] = d;
+    prev[v] = u;
+    heap.clear();
+    heap.push_back(heap_node(d, v));
+    return propagate();
+}
+
+DynamicShortestPath::num_type DynamicShortestPath::increase(const num_type &u, const num_type &v) {
+    if (prev[v] != u) {
+        return 0;  // Not in the shortest path tree
+    }
+    if (++generation == 0) {  // Wrap around, clear all stamps once
+        std::fill(affected.begin(), affected.end(), 0);
+        generation = 1;
+    }
+    // Find the affected nodes in order of their old distances, so the
+    // predecessors of a node on shortest paths are all decided before it
+    std::greater<heap_node> cmp;
+    nodes.clear();
+    heap.clear();
+    heap.push_back(heap_node(dist[v], v));
+    while (!heap.empty()) {
+        auto x = heap.front().second;
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        heap.pop_back();
+        if (isAffected(x)) {
+            continue;
+        }
+        auto parent = NOT_NODE;
+        g.getPredecessors(x, adjs);
+        for (const auto &p : adjs) {
+            if (!isAffected(p) && dist[p] < INF && dist[p] + g.getWeight(p, x) == dist[x]) {
+                parent = p;
+                break;
+            }
+        }
+        if (parent != NOT_NODE) {
+            prev[x] = parent;  // Still as short through another node
+            continue;
+        }
+        affected[x] = generation;
+        nodes.push_back(x);
+        g.getNeighbours(x, adjs);
+        for (const auto &y : adjs) {
+            if (prev[y] == x) {
+                heap.push_back(heap_node(dist[y], y));
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+
+    // Give the affected nodes their best distances through the
+    // unaffected nodes, then settle them with dijkstra
+    for (const auto &x : nodes) {
+        dist[x] = INF;
+        prev[x] = NOT_NODE;
+    }
+    for (const auto &x : nodes) {
+        g.getPredecessors(x, adjs);
+        for (const auto &p : adjs) {
+            if (!isAffected(p) && dist[p] < INF) {
+                auto d = dist[p] + g.getWeight(p, x);
+                if (d < dist[x]) {
+                    dist[x] = d;
+                    prev[x] = p;
+                }
+            }
+        }
+        if (dist[x] < INF) {
+            heap.push_back(heap_node(dist[x], x));
+        }
+    }
+    propagate();
+    return nodes.size();
+}
+
+void DynamicShortestPath::test() {
+    cout << "Test DynamicShortestPath:\n\n";
+    cin.clear();
+    Graph::num_type side;
+    unsigned updates;
+    cout << "Input grid side length and updates number: ";
+    cin >> side >> updates;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::grid(side, side, 1, 100, edges);
+    Graph g(side * side, Graph::ADJ_HASH);
+    for (const auto &e : edges) {
+        g.addEdge(e.from, e.to, e.weight);
+    }
+    auto algorithmGraph = AlgorithmGraph::getInstance();
+    auto random = Random::getInstance();
+    const num_type src = (num_type)random->randInt(0, g.size() - 1);
+    Timer timer;
+    DynamicShortestPath dsp(g, src);
+    printf("Initial shortest paths: %.2lf ms\n", timer.elapse());
+    AlgorithmGraph::Workspace ws;
+    double time[2] = { 0, 0 };
+    unsigned long long recomputed = 0;
+    bool correct = true;
+    for (unsigned i = 0; i < updates; ++i) {
+        const auto &e = edges[random->randInt(0, edges.size() - 1)];
+        timer.reset();
+        if (random->randInt(0, 3) == 0) {
+            recomputed += dsp.removeEdge(e.from, e.to);
+        } else {
+            recomputed += dsp.setWeight(e.from, e.to, (weight_type)random->randInt(1, 100));
+        }
+        time[0] += timer.elapse();
+        timer.reset();
+        algorithmGraph->dijkstra(&g, src, ws);
+        time[1] += timer.elapse();
+        for (num_type v = 0; v < g.size(); ++v) {
+            auto expected = ws.isVisited(v) ? ws.getDist(v) : INF;
+            correct = correct && dsp.getDist(v) == expected;
+        }
+    }
+    vector<num_type> path;
+    dsp.getPath(g.size() - 1, path);
+    weight_type length = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        length += g.getWeight(path[i - 1], path[i]);
+    }
+    correct = correct && (path.empty() ? dsp.getDist(g.size() - 1) >= INF
+                                       : length == dsp.getDist(g.size() - 1));
+    printf("%12s: %8.4lf ms/update\n", "repair", time[0] / updates);
+    printf("%12s: %8.4lf ms/update\n", "dijkstra", time[1] / updates);
+    printf("Nodes recomputed: %.1lf/update of %ld\n", (double)recomputed / updates, g.size());
+    printf("Check: %s\n", correct ? "pass" : "failed");
+}
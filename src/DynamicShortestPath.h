@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Base.h"
+#include "Graph.h"
+#include <utility>
+#include <vector>
+
+NS_BEGIN
+
+/*
+Single-source shortest paths kept up to date while the edges of
+the graph change (Ramalingam-Reps).
+
+After a change only the affected part of the shortest path tree
+is repaired, instead of running dijkstra again from scratch:
+1. Weight decrease or insertion of (u, v): if it shortens the path
+   to v, run dijkstra from v only. It stops at the nodes whose
+   distances do not improve.
+2. Weight increase or deletion of (u, v): nothing to do unless
+   (u, v) is in the shortest path tree. Otherwise find the affected
+   nodes in order of their old distances: a node is affected if
+   none of its predecessors on a shortest path is unaffected. Then
+   give each affected node its best distance through unaffected
+   predecessors, and run dijkstra over the affected nodes.
+(time complexity: O(D * logD) for D nodes and their edges affected)
+
+The graph is changed through this object. Edge weights must be
+positive, and there is at most one edge between two nodes. Use the
+ADJ_HASH storage of Graph, whose edge insert, delete and lookup and
+predecessor lists are O(1) per edge; the other storages work too,
+but pay a scan for every lookup.
+
+For usage, see function test().
+*/
+class DynamicShortestPath {
+public:
+    typedef Graph::num_type num_type;
+    typedef Graph::weight_type weight_type;
+
+    // Distance of an unreachable node
+    static const weight_type INF;
+
+    // Previous node of the source and unreachable nodes
+    static const num_type NOT_NODE;
+
+    /*
+    Initialize with a graph and compute the shortest paths.
+    (time complexity: O((V+E)logV))
+
+    @param g the graph, which must outlive this object
+    @param src the source node
+    @throw std::range_error if the source is not valid
+           or an edge weight is negative
+    */
+    DynamicShortestPath(Graph &g, const num_type &src);
+
+    /*
+    Set the weight of an edge, and repair the shortest paths.
+    The edge is added if it does not exist, and removed if the
+    weight is 0.
+
+    @param from the start node
+    @param to the end node
+    @param w the new weight
+    @return the number of nodes whose distance was recomputed
+    @throw std::range_error if a node is not valid or w is negative
+    */
+    num_type setWeight(const num_type &from, const num_type &to, const weight_type &w);
+
+    /*
+    Same as setWeight(from, to, w).
+    */
+    num_type addEdge(const num_type &from, const num_type &to, const weight_type &w);
+
+    /*
+    Remove an edge, and repair the shortest paths.
+
+    @param from the start node
+    @param to the end node
+    @return the number of nodes whose distance was recomputed
+    */
+    num_type removeEdge(const num_type &from, const num_type &to);
+
+    /*
+    Return the source node.
+    */
+    num_type getSource() const;
+
+    /*
+    Return the shortest distance to a node, INF if unreachable.
+    */
+    weight_type getDist(const num_type &v) const;
+
+    /*
+    Return the previous node on the shortest path to a node.
+    */
+    num_type getPrev(const num_type &v) const;
+
+    /*
+    Get the shortest path to a node.
+
+    @param des the end node
+    @param path the nodes from the source to des will be stored in
+                this field, empty if des is unreachable
+    */
+    void getPath(const num_type &des, std::vector<num_type> &path) const;
+
+private:
+    typedef std::pair<weight_type, num_type> heap_node;
+
+    Graph &g;
+    num_type src;
+
+    std::vector<weight_type> dist;
+    std::vector<num_type> prev;
+
+    // Affected by the current increase if affected[v] == generation
+    std::vector<unsigned> affected;
+    unsigned generation;
+
+    // Scratch space reused by the repairs
+    std::vector<heap_node> heap;
+    std::vector<num_type> nodes;
+    std::vector<num_type> adjs;
+
+    /*
+    Check if the node number is valid in the graph.
+
+    @throw std::range_error if the node is not valid
+    */
+    void checkValid(const num_type &n) const;
+
+    /*
+    Run dijkstra from the nodes in the heap, whose distances are
+    set already. Only the nodes whose distances improve are visited.
+
+    @return the number of nodes settled
+    */
+    num_type propagate();
+
+    /*
+    Repair after the weight of (u, v) decreased or (u, v) was added.
+    */
+    num_type decrease(const num_type &u, const num_type &v);
+
+    /*
+    Repair after the weight of (u, v) increased or (u, v) was removed.
+    */
+    num_type increase(const num_type &u, const num_type &v);
+
+    bool isAffected(const num_type &v) const;
+
+public:
+    /*
+    Test the function of the class.
+    Apply random weight changes, insertions and deletions on a
+    generated road-like graph, and compare the distances and the
+    time with a full dijkstra after each change.
+
+    Sample #1:
+    200 1000
+    */
+    static void test();
+};
+
+NS_END
@@ -0,0 +1,686 @@
+#include "FlowNetwork.h"
+#include "GraphGenerator.h"
+#include "Random.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+
+using sl::FlowNetwork;
+using sl::Graph;
+using sl::GraphGenerator;
+using sl::Random;
+using sl::Timer;
+using std::cout;
+using std::cin;
+using std::endl;
+using std::vector;
+
+namespace {
+// End of a linked list in discharge()
+const FlowNetwork::index_type NONE = (FlowNetwork::index_type)-1;
+}
+
+FlowNetwork::FlowNetwork(const num_type &n_) : n(n_), built(false) {
+    if (n < 0) {
+        throw std::range_error("FlowNetwork(): node number must be nonnegative");
+    }
+}
+
+FlowNetwork::FlowNetwork(const Graph *g) : n(g->size()), built(false) {
+    vector<Graph::Edge> edges;
+    g->getEdges(edges);
+    for (const auto &e : edges) {
+        if (e.weight > 0) {
+            addEdge(e.from, e.to, (capacity_type)std::llround(e.weight));
+        }
+    }
+}
+
+FlowNetwork::FlowNetwork(const Graph *capacity, const Graph *cost) : n(capacity->size()), built(false) {
+    if (cost->size() != n) {
+        throw std::range_error("FlowNetwork(): capacity and cost graphs have different sizes");
+    }
+    vector<Graph::Edge> edges;
+    capacity->getEdges(edges);
+    for (const auto &e : edges) {
+        if (e.weight > 0) {
+            addEdge(e.from, e.to, (capacity_type)std::llround(e.weight),
+                    (cost_type)std::llround(cost->getWeight(e.from, e.to)));
+        }
+    }
+}
+
+FlowNetwork::~FlowNetwork() {
+}
+
+FlowNetwork::num_type FlowNetwork::size() const {
+    return n;
+}
+
+FlowNetwork::arc_type FlowNetwork::edgeCount() const {
+    return (arc_type)edgeCap.size();
+}
+
+void FlowNetwork::checkValid(const num_type &v) const {
+    if (v < 0 || v >= n) {
+        throw std::range_error("FlowNetwork.checkValid(): node number is not valid");
+    }
+}
+
+FlowNetwork::arc_type FlowNetwork::addEdge(const num_type &from, const num_type &to,
+                                           const capacity_type &c, const cost_type &w) {
+    checkValid(from);
+    checkValid(to);
+    if (c < 0) {
+        throw std::range_error("FlowNetwork.addEdge(): capacity must be nonnegative");
+    }
+    edgeFrom.push_back((index_type)from);
+    edgeTo.push_back((index_type)to);
+    edgeCap.push_back(c);
+    edgeCost.push_back(w);
+    built = false;
+    return (arc_type)edgeCap.size() - 1;
+}
+
+FlowNetwork::capacity_type FlowNetwork::flow(const arc_type &edge) const {
+    if (edge >= edgeCap.size()) {
+        throw std::range_error("FlowNetwork.flow(): edge id is not valid");
+    }
+    return built ? edgeCap[edge] - cap[edgeArc[edge]] : 0;
+}
+
+void FlowNetwork::prepare() {
+    const arc_type m = (arc_type)edgeCap.size();
+    if (!built) {
+        // Counting sort of the arcs by start node
+        offsets.assign(n + 1, 0);
+        for (arc_type i = 0; i < m; ++i) {
+            ++offsets[edgeFrom[i] + 1];
+            ++offsets[edgeTo[i] + 1];
+        }
+        for (num_type v = 0; v < n; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        vector<arc_type> pos(offsets.begin(), offsets.end() - 1);
+        head.resize(2 * (size_t)m);
+        pair.resize(2 * (size_t)m);
+        edgeArc.resize(m);
+        cost.resize(2 * (size_t)m);
+        for (arc_type i = 0; i < m; ++i) {
+            auto a = pos[edgeFrom[i]]++;
+            auto b = pos[edgeTo[i]]++;
+            head[a] = edgeTo[i];
+            head[b] = edgeFrom[i];
+            pair[a] = b;
+            pair[b] = a;
+            edgeArc[i] = a;
+            cost[a] = edgeCost[i];
+            cost[b] = -edgeCost[i];
+        }
+        built = true;
+    }
+    cap.assign(2 * (size_t)m, 0);
+    for (arc_type i = 0; i < m; ++i) {
+        cap[edgeArc[i]] = edgeCap[i];
+    }
+    label.assign(n, 0);
+    current.assign(n, 0);
+    excess.assign(n, 0);
+}
+
+void FlowNetwork::bfsLabel(const index_type des, const bool reverse) {
+    std::fill(label.begin(), label.end(), (index_type)n);
+    vector<index_type> q(1, des);
+    label[des] = 0;
+    for (size_t i = 0; i < q.size(); ++i) {
+        auto u = q[i];
+        for (auto a = offsets[u]; a < offsets[u + 1]; ++a) {
+            auto v = head[a];
+            // Residual arc u->v (from des) or v->u (to des)
+            if (label[v] == (index_type)n && (reverse ? cap[a] : cap[pair[a]]) > 0) {
+                label[v] = label[u] + 1;
+                q.push_back(v);
+            }
+        }
+    }
+}
+
+FlowNetwork::capacity_type FlowNetwork::dinic(const num_type &src, const num_type &des) {
+    checkValid(src);
+    checkValid(des);
+    if (src == des) {
+        throw std::range_error("FlowNetwork.dinic(): source and sink must be different");
+    }
+    prepare();
+    auto s = (index_type)src, t = (index_type)des;
+    capacity_type res = 0;
+    vector<arc_type> path;
+    while (1) {
+        bfsLabel(s, true);  // Level graph
+        if (label[t] == (index_type)n) {
+            break;
+        }
+        for (num_type v = 0; v < n; ++v) {
+            current[v] = offsets[v];
+        }
+        // Blocking flow by DFS, path holds the arcs from s to u
+        path.clear();
+        auto u = s;
+        while (1) {
+            if (u == t) {
+                auto f = cap[path[0]];
+                for (auto a : path) {
+                    f = std::min(f, cap[a]);
+                }
+                size_t k = path.size();
+                for (size_t i = 0; i < path.size(); ++i) {
+                    cap[path[i]] -= f;
+                    cap[pair[path[i]]] += f;
+                    if (cap[path[i]] == 0 && k == path.size()) {
+                        k = i;
+                    }
+                }
+                res += f;
+                // Go back to the start of the first saturated arc
+                path.resize(k);
+                u = k == 0 ? s : head[path[k - 1]];
+                continue;
+            }
+            auto a = current[u];
+            const auto end = offsets[u + 1];
+            for (; a < end; ++a) {
+                auto v = head[a];
+                if (cap[a] > 0 && label[v] == label[u] + 1 && (label[v] < label[t] || v == t)) {
+                    break;
+                }
+            }
+            current[u] = a;
+            if (a < end) {  // Advance
+                path.push_back(a);
+                u = head[a];
+                continue;
+            }
+            if (u == s) {  // Blocked
+                break;
+            }
+            // Retreat, u is a dead end for this phase
+            path.pop_back();
+            u = path.empty() ? s : head[path.back()];
+            ++current[u];
+        }
+    }
+    return res;
+}
+
+void FlowNetwork::discharge(const index_type src, const index_type des) {
+    const auto top = (index_type)n;
+    vector<index_type> activeHead(n, NONE), activeNext(n, NONE);
+    vector<index_type> allHead(n, NONE), allNext(n, NONE), allPrev(n, NONE);
+    long long maxActive = -1, maxLabel = 0;
+    auto pushActive = [&](const index_type v) {
+        activeNext[v] = activeHead[label[v]];
+        activeHead[label[v]] = v;
+        maxActive = std::max(maxActive, (long long)label[v]);
+    };
+    auto insertAll = [&](const index_type v) {
+        auto h = label[v];
+        allPrev[v] = NONE;
+        allNext[v] = allHead[h];
+        if (allHead[h] != NONE) {
+            allPrev[allHead[h]] = v;
+        }
+        allHead[h] = v;
+        maxLabel = std::max(maxLabel, (long long)h);
+    };
+    auto removeAll = [&](const index_type v) {
+        if (allPrev[v] != NONE) {
+            allNext[allPrev[v]] = allNext[v];
+        } else {
+            allHead[label[v]] = allNext[v];
+        }
+        if (allNext[v] != NONE) {
+            allPrev[allNext[v]] = allPrev[v];
+        }
+    };
+    // Exact labels from BFS, and lists rebuilt from them
+    auto globalRelabel = [&]() {
+        bfsLabel(des, false);
+        label[src] = top;
+        std::fill(activeHead.begin(), activeHead.end(), NONE);
+        std::fill(allHead.begin(), allHead.end(), NONE);
+        maxActive = -1;
+        maxLabel = 0;
+        for (index_type v = 0; v < top; ++v) {
+            current[v] = offsets[v];
+            if (label[v] < top) {
+                insertAll(v);
+                if (excess[v] > 0 && v != des) {
+                    pushActive(v);
+                }
+            }
+        }
+    };
+    const unsigned long long relabelWork = 6ULL * n + head.size() / 2;
+    unsigned long long work = 0;
+    globalRelabel();
+    while (maxActive >= 0) {
+        auto u = activeHead[maxActive];
+        if (u == NONE) {
+            --maxActive;
+            continue;
+        }
+        activeHead[maxActive] = activeNext[u];
+        if (label[u] != maxActive || excess[u] == 0) {
+            continue;
+        }
+        while (excess[u] > 0) {
+            // Push along admissible arcs
+            auto a = current[u];
+            const auto end = offsets[u + 1];
+            for (; a < end; ++a) {
+                auto v = head[a];
+                if (cap[a] > 0 && label[u] == label[v] + 1) {
+                    auto d = std::min(excess[u], cap[a]);
+                    if (excess[v] == 0 && v != des && v != src) {
+                        pushActive(v);
+                    }
+                    cap[a] -= d;
+                    cap[pair[a]] += d;
+                    excess[u] -= d;
+                    excess[v] += d;
+                    if (excess[u] == 0) {
+                        break;
+                    }
+                }
+            }
+            current[u] = a;
+            if (excess[u] == 0) {
+                break;
+            }
+            // Relabel
+            work += end - offsets[u] + 12;
+            auto old = label[u];
+            removeAll(u);
+            if (allHead[old] == NONE) {
+                // Gap: the nodes above can not reach des any more
+                for (auto h = (long long)old + 1; h <= maxLabel; ++h) {
+                    for (auto v = allHead[h]; v != NONE; v = allNext[v]) {
+                        label[v] = top;
+                    }
+                    allHead[h] = NONE;
+                    activeHead[h] = NONE;
+                }
+                maxLabel = (long long)old - 1;
+                label[u] = top;
+                break;
+            }
+            auto h = top;
+            for (auto b = offsets[u]; b < end; ++b) {
+                if (cap[b] > 0) {
+                    h = std::min(h, label[head[b]] + 1);
+                }
+            }
+            current[u] = offsets[u];
+            label[u] = h;
+            if (h >= top) {
+                break;
+            }
+            insertAll(u);
+            maxActive = std::max(maxActive, (long long)h);
+        }
+        if (work > relabelWork) {
+            globalRelabel();
+            work = 0;
+        }
+    }
+}
+
+FlowNetwork::capacity_type FlowNetwork::pushRelabel(const num_type &src, const num_type &des) {
+    checkValid(src);
+    checkValid(des);
+    if (src == des) {
+        throw std::range_error("FlowNetwork.pushRelabel(): source and sink must be different");
+    }
+    prepare();
+    auto s = (index_type)src, t = (index_type)des;
+    for (auto a = offsets[s]; a < offsets[s + 1]; ++a) {
+        auto f = cap[a];
+        cap[a] -= f;
+        cap[pair[a]] += f;
+        excess[head[a]] += f;
+        excess[s] -= f;
+    }
+    // Phase 1: a maximum preflow, then phase 2: return the excess
+    // left on other nodes to the source to get a flow
+    discharge(s, t);
+    discharge(t, s);
+    return excess[t];
+}
+
+FlowNetwork::CostFlow FlowNetwork::minCostFlow(const num_type &src, const num_type &des,
+                                               const capacity_type &limit) {
+    typedef std::pair<cost_type, index_type> heap_node;
+    checkValid(src);
+    checkValid(des);
+    if (src == des) {
+        throw std::range_error("FlowNetwork.minCostFlow(): source and sink must be different");
+    }
+    prepare();
+    auto s = (index_type)src, t = (index_type)des;
+    const cost_type inf = std::numeric_limits<cost_type>::max();
+    vector<cost_type> potential(n, 0), dist(n, inf);
+    vector<arc_type> path;
+    vector<bool> onPath(n, false);
+    if (std::any_of(edgeCost.begin(), edgeCost.end(), [](const cost_type c) { return c < 0; })) {
+        // Bellman-Ford (queue version) for the first potentials, from a
+        // virtual source with zero cost arcs to all nodes, so that a
+        // negative cycle anywhere in the network is found
+        vector<unsigned> count(n, 0);
+        vector<bool> inQueue(n, true);
+        std::queue<index_type> q;
+        for (index_type v = 0; v < (index_type)n; ++v) {
+            dist[v] = 0;
+            q.push(v);
+        }
+        while (!q.empty()) {
+            auto u = q.front();
+            q.pop();
+            inQueue[u] = false;
+            for (auto a = offsets[u]; a < offsets[u + 1]; ++a) {
+                auto v = head[a];
+                if (cap[a] > 0 && dist[u] + cost[a] < dist[v]) {
+                    dist[v] = dist[u] + cost[a];
+                    if (!inQueue[v]) {
+                        if (++count[v] > (unsigned)n) {
+                            throw std::range_error("FlowNetwork.minCostFlow(): negative cost cycle found");
+                        }
+                        inQueue[v] = true;
+                        q.push(v);
+                    }
+                }
+            }
+        }
+        potential = dist;
+    }
+    CostFlow res = { 0, 0 };
+    std::priority_queue<heap_node, vector<heap_node>, std::greater<heap_node>> q;
+    while (res.flow < limit) {
+        // Dijkstra with reduced costs cost + potential[u] - potential[v] >= 0,
+        // stop once the sink is settled
+        std::fill(dist.begin(), dist.end(), inf);
+        dist[s] = 0;
+        q = decltype(q)();
+        q.push(heap_node(0, s));
+        while (!q.empty()) {
+            auto d = q.top().first;
+            auto u = q.top().second;
+            q.pop();
+            if (d > dist[u]) {
+                continue;  // Outdated heap node
+            }
+            if (u == t) {
+                break;
+            }
+            for (auto a = offsets[u]; a < offsets[u + 1]; ++a) {
+                auto v = head[a];
+                if (cap[a] > 0) {
+                    auto nd = d + cost[a] + potential[u] - potential[v];
+                    if (nd < dist[v]) {
+                        dist[v] = nd;
+                        q.push(heap_node(nd, v));
+                    }
+                }
+            }
+        }
+        if (dist[t] == inf) {  // No augmenting path
+            break;
+        }
+        // Nodes not settled are at least as far as the sink
+        for (num_type v = 0; v < n; ++v) {
+            potential[v] += std::min(dist[v], dist[t]);
+        }
+        // All the residual paths of zero reduced cost are shortest now,
+        // augment along them by DFS with current-arc pointers
+        for (num_type v = 0; v < n; ++v) {
+            current[v] = offsets[v];
+        }
+        path.clear();
+        auto u = s;
+        onPath[s] = true;
+        while (res.flow < limit) {
+            if (u == t) {
+                auto f = limit - res.flow;
+                for (auto a : path) {
+                    f = std::min(f, cap[a]);
+                }
+                size_t k = path.size();
+                for (size_t i = 0; i < path.size(); ++i) {
+                    auto a = path[i];
+                    cap[a] -= f;
+                    cap[pair[a]] += f;
+                    res.cost += f * cost[a];
+                    if (cap[a] == 0 && k == path.size()) {
+                        k = i;
+                    }
+                }
+                res.flow += f;
+                // Go back to the start of the first saturated arc
+                for (auto i = k; i < path.size(); ++i) {
+                    onPath[head[path[i]]] = false;
+                }
+                path.resize(k);
+                u = k == 0 ? s : head[path[k - 1]];
+                continue;
+            }
+            auto a = current[u];
+            const auto end = offsets[u + 1];
+            for (; a < end; ++a) {
+                auto v = head[a];
+                if (cap[a] > 0 && !onPath[v] && cost[a] + potential[u] - potential[v] == 0
+                    && (v == t || current[v] < offsets[v + 1])) {
+                    break;
+                }
+            }
+            current[u] = a;
+            if (a < end) {  // Advance
+                path.push_back(a);
+                u = head[a];
+                onPath[u] = true;
+                continue;
+            }
+            if (u == s) {
+                break;
+            }
+            // Retreat, u is a dead end until the next Dijkstra
+            onPath[u] = false;
+            path.pop_back();
+            u = path.empty() ? s : head[path.back()];
+            ++current[u];
+        }
+        for (auto a : path) {
+            onPath[head[a]] = false;
+        }
+        onPath[s] = false;
+    }
+    return res;
+}
+
+FlowNetwork::cost_type FlowNetwork::flowCost() const {
+    cost_type res = 0;
+    for (arc_type i = 0; i < edgeCost.size(); ++i) {
+        res += flow(i) * edgeCost[i];
+    }
+    return res;
+}
+
+void FlowNetwork::refine(const vector<cost_type> &scaled, vector<cost_type> &price,
+                         const cost_type eps) {
+    // Saturate the arcs with negative reduced cost, which makes
+    // the flow 0-optimal but leaves excess on some nodes
+    std::fill(excess.begin(), excess.end(), 0);
+    for (index_type u = 0; u < (index_type)n; ++u) {
+        current[u] = offsets[u];
+        for (auto a = offsets[u]; a < offsets[u + 1]; ++a) {
+            auto v = head[a];
+            if (cap[a] > 0 && scaled[a] + price[u] - price[v] < 0) {
+                excess[u] -= cap[a];
+                excess[v] += cap[a];
+                cap[pair[a]] += cap[a];
+                cap[a] = 0;
+            }
+        }
+    }
+    std::queue<index_type> q;
+    vector<bool> inQueue(n, false);
+    for (index_type u = 0; u < (index_type)n; ++u) {
+        if (excess[u] > 0) {
+            inQueue[u] = true;
+            q.push(u);
+        }
+    }
+    while (!q.empty()) {
+        auto u = q.front();
+        q.pop();
+        inQueue[u] = false;
+        while (excess[u] > 0) {
+            // Push along admissible arcs (reduced cost < 0)
+            auto a = current[u];
+            const auto end = offsets[u + 1];
+            for (; a < end; ++a) {
+                auto v = head[a];
+                if (cap[a] > 0 && scaled[a] + price[u] - price[v] < 0) {
+                    auto d = std::min(excess[u], cap[a]);
+                    cap[a] -= d;
+                    cap[pair[a]] += d;
+                    excess[u] -= d;
+                    excess[v] += d;
+                    if (excess[v] > 0 && !inQueue[v]) {
+                        inQueue[v] = true;
+                        q.push(v);
+                    }
+                    if (excess[u] == 0) {
+                        break;
+                    }
+                }
+            }
+            current[u] = a;
+            if (excess[u] == 0) {
+                break;
+            }
+            // Relabel: lower the price so that the best residual arc
+            // gets reduced cost -eps
+            auto best = std::numeric_limits<cost_type>::min();
+            for (auto b = offsets[u]; b < end; ++b) {
+                if (cap[b] > 0) {
+                    best = std::max(best, price[head[b]] - scaled[b]);
+                }
+            }
+            price[u] = best - eps;
+            current[u] = offsets[u];
+        }
+    }
+}
+
+FlowNetwork::CostFlow FlowNetwork::costScaling(const num_type &src, const num_type &des) {
+    // Alpha, the factor eps is divided by in each round
+    const cost_type alpha = 8;
+    CostFlow res;
+    res.flow = dinic(src, des);  // Any maximum flow to start with
+    // With costs multiplied by (n + 1), a 1-optimal flow is optimal
+    vector<cost_type> scaled(cost.size());
+    cost_type eps = 0;
+    for (size_t a = 0; a < cost.size(); ++a) {
+        scaled[a] = cost[a] * (n + 1);
+        eps = std::max(eps, std::abs(scaled[a]));
+    }
+    vector<cost_type> price(n, 0);
+    while (eps > 1) {
+        eps = std::max<cost_type>(1, eps / alpha);
+        refine(scaled, price, eps);
+    }
+    res.cost = flowCost();
+    return res;
+}
+
+void FlowNetwork::minCut(const num_type &src, vector<bool> &sourceSide) const {
+    checkValid(src);
+    sourceSide.assign(n, false);
+    if (!built) {
+        return;
+    }
+    vector<index_type> q(1, (index_type)src);
+    sourceSide[src] = true;
+    for (size_t i = 0; i < q.size(); ++i) {
+        auto u = q[i];
+        for (auto a = offsets[u]; a < offsets[u + 1]; ++a) {
+            auto v = head[a];
+            if (!sourceSide[v] && cap[a] > 0) {
+                sourceSide[v] = true;
+                q.push_back(v);
+            }
+        }
+    }
+}
+
+void FlowNetwork::test() {
+    cout << "Test FlowNetwork:\n\n";
+    cin.clear();
+    unsigned scale, edgeFactor;
+    cout << "Input scale and edge factor of the network: ";
+    cin >> scale >> edgeFactor;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::rmat(scale, edgeFactor, 1, 100, false, edges);
+    FlowNetwork net(1LL << scale);
+    auto random = Random::getInstance();
+    for (const auto &e : edges) {
+        net.addEdge(e.from, e.to, (capacity_type)e.weight, random->randInt(1, 100));
+    }
+    printf("Network: %lld nodes, %u edges, source 0, sink 1\n", (long long)net.size(), net.edgeCount());
+    // Check capacity constraints, conservation and the min cut
+    auto check = [&](const capacity_type value) {
+        vector<capacity_type> balance(net.size(), 0);
+        for (arc_type i = 0; i < net.edgeCount(); ++i) {
+            auto f = net.flow(i);
+            if (f < 0 || f > net.edgeCap[i]) {
+                return false;
+            }
+            balance[net.edgeFrom[i]] -= f;
+            balance[net.edgeTo[i]] += f;
+        }
+        for (num_type v = 2; v < net.size(); ++v) {
+            if (balance[v] != 0) {
+                return false;
+            }
+        }
+        vector<bool> side;
+        net.minCut(0, side);
+        capacity_type cut = 0;
+        for (arc_type i = 0; i < net.edgeCount(); ++i) {
+            if (side[net.edgeFrom[i]] && !side[net.edgeTo[i]]) {
+                cut += net.edgeCap[i];
+            }
+        }
+        return balance[1] == value && cut == value;
+    };
+    Timer timer;
+    auto value = net.dinic(0, 1);
+    printf("%15s: %10.2lf ms, max flow %lld, check %s\n", "Dinic", timer.elapse(),
+           value, check(value) ? "pass" : "failed");
+    timer.reset();
+    value = net.pushRelabel(0, 1);
+    printf("%15s: %10.2lf ms, max flow %lld, check %s\n", "push-relabel", timer.elapse(),
+           value, check(value) ? "pass" : "failed");
+    timer.reset();
+    auto res = net.minCostFlow(0, 1);
+    printf("%15s: %10.2lf ms, max flow %lld, min cost %lld, check %s\n", "SSP", timer.elapse(),
+           res.flow, res.cost, check(res.flow) ? "pass" : "failed");
+    timer.reset();
+    res = net.costScaling(0, 1);
+    printf("%15s: %10.2lf ms, max flow %lld, min cost %lld, check %s\n", "cost scaling", timer.elapse(),
+           res.flow, res.cost, check(res.flow) ? "pass" : "failed");
+}
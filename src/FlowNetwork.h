@@ -0,0 +1,258 @@
+#pragma once
+
+#include "Base.h"
+#include "Graph.h"
+#include <limits>
+#include <vector>
+
+NS_BEGIN
+
+/*
+A flow network stored in a residual edge array, with maximum
+flow and minimum cost flow algorithms for large sparse networks.
+
+Each edge u->v is stored as two arcs: the forward arc in the
+arcs of u, and the reverse arc in the arcs of v. The arcs of a
+node are contiguous (CSR order), and each arc knows the position
+of its pair, so pushing flow along an arc is O(1).
+
+The arc arrays are built from the edge list on the first run.
+Each run starts from zero flow; after a run, flow() returns the
+flow of each edge.
+
+Two algorithms are provided:
+1. Dinic: find the level graph of shortest residual paths with
+   BFS, then a blocking flow with DFS, where the current arc of
+   each node only moves forward. (time complexity: O(V^2 * E))
+2. Push-relabel with highest-label selection, the gap heuristic
+   and periodic global relabeling. (time complexity: O(V^2 * sqrt(E)))
+
+Each edge also has a cost per unit of flow, and the minimum cost
+maximum flow is found by:
+1. Successive shortest paths: Dijkstra on reduced costs updates
+   Johnson potentials, which keep the reduced costs nonnegative
+   (initialized by Bellman-Ford if some costs are negative), then
+   the flow is augmented along all the residual paths of zero
+   reduced cost. (time complexity: O(F * E * logV), F is the number
+   of Dijkstra runs)
+2. Cost scaling: start from a maximum flow, then refine it to be
+   eps-optimal (no residual arc has reduced cost below -eps) for eps
+   divided by a constant each round, with push-relabel on the
+   admissible arcs, until the flow is optimal.
+   (time complexity: O(V^2 * E * log(V * C)), C is the max cost)
+
+Capacities and costs are integers to keep the flow exact.
+
+For usage, see function test().
+*/
+class FlowNetwork {
+public:
+    typedef Graph::num_type num_type;
+    typedef long long capacity_type;
+    typedef long long cost_type;
+
+    // Type for node number value in the arrays
+    typedef unsigned index_type;
+
+    // Type for arc position and edge id
+    typedef unsigned arc_type;
+
+    /*
+    Result of a minimum cost flow.
+    */
+    struct CostFlow {
+        capacity_type flow;  // Value of the flow
+        cost_type cost;      // Sum of flow * cost of the edges
+    };
+
+    /*
+    Initialize a network without edges.
+
+    @param n the number of nodes
+    */
+    FlowNetwork(const num_type &n);
+
+    /*
+    Initialize from a graph, each edge with a positive weight
+    becomes an edge with the weight as its capacity.
+    Edge ids are in the order of Graph::getEdges().
+
+    @param g the graph object
+    */
+    FlowNetwork(const Graph *g);
+
+    /*
+    Initialize from a capacity graph and a cost graph, in the same
+    way as above. The cost of edge (u, v) is cost->getWeight(u, v).
+
+    @param capacity the capacity graph
+    @param cost the cost graph
+    */
+    FlowNetwork(const Graph *capacity, const Graph *cost);
+
+    ~FlowNetwork();
+
+    /*
+    Return the number of nodes.
+    */
+    num_type size() const;
+
+    /*
+    Return the number of edges.
+    */
+    arc_type edgeCount() const;
+
+    /*
+    Add an edge.
+
+    @param from the start node
+    @param to the end node
+    @param cap the capacity, must be nonnegative
+    @param cost the cost per unit of flow
+    @return the id of the edge
+    */
+    arc_type addEdge(const num_type &from, const num_type &to,
+                     const capacity_type &cap, const cost_type &cost = 0);
+
+    /*
+    Return the flow on an edge after the last run.
+
+    @param edge the id of the edge
+    */
+    capacity_type flow(const arc_type &edge) const;
+
+    /*
+    Compute the maximum flow with Dinic's algorithm.
+
+    @param src the source node
+    @param des the sink node
+    @return the maximum flow value
+    */
+    capacity_type dinic(const num_type &src, const num_type &des);
+
+    /*
+    Compute the maximum flow with highest-label push-relabel.
+
+    @param src the source node
+    @param des the sink node
+    @return the maximum flow value
+    */
+    capacity_type pushRelabel(const num_type &src, const num_type &des);
+
+    /*
+    Compute a minimum cost flow with successive shortest paths.
+    There must be no negative cost cycle, anywhere in the network.
+
+    @param src the source node
+    @param des the sink node
+    @param limit stop when the flow reaches this value, a maximum
+                 flow is found by default
+    @return the flow value and its cost
+    @throw std::range_error if a negative cost cycle is found
+    */
+    CostFlow minCostFlow(const num_type &src, const num_type &des,
+                         const capacity_type &limit = std::numeric_limits<capacity_type>::max());
+
+    /*
+    Compute a minimum cost maximum flow with cost scaling.
+    Negative costs and negative cycles are allowed.
+
+    @param src the source node
+    @param des the sink node
+    @return the flow value and its cost
+    */
+    CostFlow costScaling(const num_type &src, const num_type &des);
+
+    /*
+    Find the source side of a minimum cut after a run:
+    the nodes reachable from src in the residual network.
+
+    @param src the source node of the last run
+    @param sourceSide the result will be stored in this field
+    */
+    void minCut(const num_type &src, std::vector<bool> &sourceSide) const;
+
+private:
+    num_type n;
+
+    // Edge list in the order of addEdge()
+    std::vector<index_type> edgeFrom;
+    std::vector<index_type> edgeTo;
+    std::vector<capacity_type> edgeCap;
+    std::vector<cost_type> edgeCost;
+
+    // Arc arrays, built from the edge list
+    bool built;
+    std::vector<arc_type> offsets;     // Size n + 1
+    std::vector<index_type> head;      // End node of each arc
+    std::vector<arc_type> pair;        // Position of the reverse arc
+    std::vector<capacity_type> cap;    // Residual capacity of each arc
+    std::vector<cost_type> cost;       // Cost of each arc, negative for reverse arcs
+    std::vector<arc_type> edgeArc;     // Position of the forward arc of each edge
+
+    // Per-node work arrays of the algorithms
+    std::vector<index_type> label;
+    std::vector<arc_type> current;
+    std::vector<capacity_type> excess;
+
+    /*
+    Check if the node number is valid in the network.
+
+    @throw std::range_error if the node is not valid
+    */
+    void checkValid(const num_type &v) const;
+
+    /*
+    Build the arc arrays if needed, and reset to zero flow.
+    */
+    void prepare();
+
+    /*
+    Label the nodes by BFS distance to des in the residual network,
+    n for the nodes that can not reach des. (used by Dinic with
+    the arcs reversed: distance from src)
+
+    @param des the node to start from
+    @param reverse true to use the arcs from des instead of to des
+    */
+    void bfsLabel(const index_type des, const bool reverse);
+
+    /*
+    Run push-relabel until no node other than src and des has
+    excess and can reach des.
+
+    @param src the node which is never active
+    @param des the node to push the excess to
+    */
+    void discharge(const index_type src, const index_type des);
+
+    /*
+    Return the cost of the current flow.
+    */
+    cost_type flowCost() const;
+
+    /*
+    Make the current flow eps-optimal with respect to the scaled
+    costs, keeping the flow value. (used by costScaling)
+
+    @param scaled the cost of each arc multiplied by (n + 1)
+    @param price the node potentials
+    @param eps the target eps
+    */
+    void refine(const std::vector<cost_type> &scaled, std::vector<cost_type> &price,
+                const cost_type eps);
+
+public:
+    /*
+    Test the function of the class.
+    Compare the algorithms on a generated power-law network from
+    node 0 to node 1 (the two largest hubs) with random costs, and
+    check the flows.
+
+    Sample #1:
+    14 8
+    */
+    static void test();
+};
+
+NS_END
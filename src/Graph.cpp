@@ -24,6 +24,10 @@ Graph::Graph(const num_type &n, const StorageType &type_)
                 adjMatrix.push_back(vector<weight_type>(n, 0));
             }
             break;
+        case ADJ_HASH:
+            outAdj.resize(n);
+            inAdj.resize(n);
+            break;
         default:
             break;
     }
@@ -38,6 +42,7 @@ Graph::~Graph() {
             }
             break;
         case ADJ_MATRIX:
+        case ADJ_HASH:
             break;
         default:
             break;
@@ -58,6 +63,24 @@ Graph::num_type Graph::size() const {
     return size_;
 }
 
+unsigned long long Graph::edgeKey(const num_type &from, const num_type &to) const {
+    return (unsigned long long)from * size_ + to;
+}
+
+void Graph::eraseAdj(vector<AdjNode> &adjs, const num_type pos,
+                     const num_type &node, const bool out) {
+    if (pos + 1 != (num_type)adjs.size()) {
+        adjs[pos] = adjs.back();
+        auto moved = adjs[pos].num;
+        if (out) {
+            edgePos[edgeKey(node, moved)].out = pos;
+        } else {
+            edgePos[edgeKey(moved, node)].in = pos;
+        }
+    }
+    adjs.pop_back();
+}
+
 void Graph::getNeighbours(const num_type &n,
                           vector<num_type> &nodes) const {
     checkValid(n);
@@ -79,6 +102,80 @@ void Graph::getNeighbours(const num_type &n,
                 }
             }
             break;
+        case ADJ_HASH:
+            for (const auto &adjNode : outAdj[n]) {
+                nodes.push_back(adjNode.num);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Graph::getPredecessors(const num_type &n,
+                            vector<num_type> &nodes) const {
+    checkValid(n);
+    nodes.clear();
+    switch (type) {
+        case ADJ_LIST:
+            for (num_type i = 0; i < size_; ++i) {
+                auto adjNodes = adjList[i].adjNodes;
+                if (adjNodes) {
+                    for (const auto &adjNode : (*adjNodes)) {
+                        if (adjNode.num == n) {
+                            nodes.push_back(i);
+                            break;
+                        }
+                    }
+                }
+            }
+            break;
+        case ADJ_MATRIX:
+            for (auto i = 0; i < size_; ++i) {
+                if (!isZero(adjMatrix[i][n])) {
+                    nodes.push_back(i);
+                }
+            }
+            break;
+        case ADJ_HASH:
+            for (const auto &adjNode : inAdj[n]) {
+                nodes.push_back(adjNode.num);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Graph::getEdges(vector<Edge> &edges) const {
+    edges.clear();
+    switch (type) {
+        case ADJ_LIST:
+            for (num_type i = 0; i < size_; ++i) {
+                auto adjNodes = adjList[i].adjNodes;
+                if (adjNodes) {
+                    for (const auto &adjNode : (*adjNodes)) {
+                        edges.push_back(Edge(i, adjNode.num, adjNode.weight));
+                    }
+                }
+            }
+            break;
+        case ADJ_MATRIX:
+            for (num_type i = 0; i < size_; ++i) {
+                for (num_type j = 0; j < size_; ++j) {
+                    if (!isZero(adjMatrix[i][j])) {
+                        edges.push_back(Edge(i, j, adjMatrix[i][j]));
+                    }
+                }
+            }
+            break;
+        case ADJ_HASH:
+            for (num_type i = 0; i < size_; ++i) {
+                for (const auto &adjNode : outAdj[i]) {
+                    edges.push_back(Edge(i, adjNode.num, adjNode.weight));
+                }
+            }
+            break;
         default:
             break;
     }
@@ -105,6 +202,13 @@ Graph::weight_type Graph::getWeight(const num_type &from,
         case ADJ_MATRIX:
             res = adjMatrix[from][to];
             break;
+        case ADJ_HASH: {
+            auto it = edgePos.find(edgeKey(from, to));
+            if (it != edgePos.end()) {
+                res = outAdj[from][it->second.out].weight;
+            }
+            break;
+        }
         default:
             break;
     }
@@ -133,6 +237,11 @@ void Graph::setWeight(const num_type &from, const num_type &to, const weight_typ
         case ADJ_MATRIX:
             adjMatrix[from][to] = w;
             break;
+        case ADJ_HASH:
+            if (!isZero(w)) {
+                addEdge(from, to, w);
+            }
+            break;
         default:
             break;
     }
@@ -166,6 +275,22 @@ void Graph::addEdge(const num_type &from, const num_type &to, const weight_type
         case ADJ_MATRIX:
             adjMatrix[from][to] = w;
             break;
+        case ADJ_HASH: {
+            if (!isZero(w)) {
+                auto res = edgePos.insert(std::make_pair(edgeKey(from, to), EdgePos()));
+                auto &pos = res.first->second;
+                if (res.second) {
+                    pos.out = outAdj[from].size();
+                    pos.in = inAdj[to].size();
+                    outAdj[from].push_back(AdjNode(to, w));
+                    inAdj[to].push_back(AdjNode(from, w));
+                } else {
+                    outAdj[from][pos.out].weight = w;
+                    inAdj[to][pos.in].weight = w;
+                }
+            }
+            break;
+        }
         default:
             break;
     }
@@ -192,6 +317,16 @@ void Graph::removeEdge(const num_type &from, const num_type &to) {
         case ADJ_MATRIX:
             adjMatrix[from][to] = 0;
             break;
+        case ADJ_HASH: {
+            auto it = edgePos.find(edgeKey(from, to));
+            if (it != edgePos.end()) {
+                auto pos = it->second;
+                edgePos.erase(it);
+                eraseAdj(outAdj[from], pos.out, from, true);
+                eraseAdj(inAdj[to], pos.in, to, false);
+            }
+            break;
+        }
         default:
             break;
     }
@@ -210,6 +345,9 @@ void Graph::print() const {
         case ADJ_MATRIX:
             cout << "adjacent matrix.\n";
             break;
+        case ADJ_HASH:
+            cout << "adjacent vectors with a hash index.\n";
+            break;
         default:
             break;
     }
@@ -237,7 +375,7 @@ void Graph::test() {
     num_type size;
     cin >> size;
     cout << endl;
-    Graph g1(size), g2(size, Graph::StorageType::ADJ_MATRIX);
+    Graph g1(size), g2(size, Graph::StorageType::ADJ_MATRIX), g3(size, Graph::StorageType::ADJ_HASH);
     num_type a, b;
     weight_type w;
     string oper;
@@ -254,19 +392,24 @@ void Graph::test() {
             cin >> a >> b >> w;
             g1.addEdge(a, b, w);
             g2.addEdge(a, b, w);
+            g3.addEdge(a, b, w);
         } else if (oper == "r") {
             cin >> a >> b;
             g1.removeEdge(a, b);
             g2.removeEdge(a, b);
+            g3.removeEdge(a, b);
         } else if (oper == "p") {
             cout << "Type1:" << endl;
             g1.print();
             cout << "\nType2:" << endl;
             g2.print();
+            cout << "\nType3:" << endl;
+            g3.print();
         } else if (oper == "sw") {
             cin >> a >> b >> w;
             g1.setWeight(a, b, w);
             g2.setWeight(a, b, w);
+            g3.setWeight(a, b, w);
         } else {
             cout << "Invalid operation." << endl;
         }
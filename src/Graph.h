@@ -2,6 +2,7 @@
 
 #include "Base.h"
 #include <list>
+#include <unordered_map>
 #include <vector>
 
 NS_BEGIN
@@ -23,12 +24,30 @@ public:
     // if there is not edge between two nodes
     static const weight_type NONE_EDGE_WEIGHT;
 
+    /*
+    Definition of an edge.
+    */
+    struct Edge {
+        num_type from;
+        num_type to;
+        weight_type weight;
+
+        Edge(const num_type from_ = 0, const num_type to_ = 0, const weight_type w = 0)
+            : from(from_), to(to_), weight(w) {}
+    };
+
     /*
     Definition of the storage type of the graph.
+
+    ADJ_HASH keeps the out and in adjacents of each node in vectors
+    and indexes every edge by its two nodes in a hash table, so that
+    adding, removing, finding an edge and changing its weight are all
+    O(1) amortized. There is at most one edge between two nodes.
     */
     enum StorageType {
         ADJ_LIST,
-        ADJ_MATRIX
+        ADJ_MATRIX,
+        ADJ_HASH
     };
 
     /*
@@ -69,6 +88,22 @@ public:
     */
     void getNeighbours(const num_type &n, std::vector<num_type> &nodes) const;
 
+    /*
+    Get the nodes which have an edge to one node.
+    (time complexity: O(in degree) with ADJ_HASH, O(V+E) with ADJ_LIST)
+
+    @param n the node to find
+    @param nodes the result will be stored in this field
+    */
+    void getPredecessors(const num_type &n, std::vector<num_type> &nodes) const;
+
+    /*
+    Get all the edges of the graph, ordered by the start node.
+
+    @param edges the result will be stored in this field
+    */
+    void getEdges(std::vector<Edge> &edges) const;
+
     /*
     Get the weight of the edge between two nodes.
 
@@ -80,7 +115,8 @@ public:
     weight_type getWeight(const num_type &from, const num_type &to) const;
 
     /*
-    Set the weight of the edge between two nodes.
+    Set the weight of the edge between two nodes. With ADJ_HASH
+    the edge is added if it does not exist.
 
     @param from the start node
     @param to the end node
@@ -98,7 +134,8 @@ public:
     void increaseWeight(const num_type &from, const num_type &to, const weight_type &increase);
 
     /*
-    Add an edge between two nodes.
+    Add an edge between two nodes. With ADJ_HASH the weight of an
+    existing edge is replaced.
 
     @param from the start node
     @param to the end node
@@ -146,6 +183,20 @@ private:
 
     std::vector<std::vector<weight_type>> adjMatrix;
 
+    /*
+    Positions of an edge in the adjacent vectors of ADJ_HASH.
+    */
+    struct EdgePos {
+        num_type out;  // In outAdj[from]
+        num_type in;   // In inAdj[to]
+    };
+
+    std::vector<std::vector<AdjNode>> outAdj;
+
+    std::vector<std::vector<AdjNode>> inAdj;
+
+    std::unordered_map<unsigned long long, EdgePos> edgePos;
+
     StorageType type;
 
     num_type size_;
@@ -158,6 +209,23 @@ private:
     */
     void checkValid(const num_type &n) const;
 
+    /*
+    Return the key of an edge in the hash table of ADJ_HASH.
+    */
+    unsigned long long edgeKey(const num_type &from, const num_type &to) const;
+
+    /*
+    Remove the element at pos from an adjacent vector of ADJ_HASH by
+    moving the last element there, and fix the position of the moved edge.
+
+    @param adjs the adjacent vector
+    @param pos the position to remove
+    @param node the node owning the vector
+    @param out whether adjs is an out adjacent vector
+    */
+    void eraseAdj(std::vector<AdjNode> &adjs, const num_type pos,
+                  const num_type &node, const bool out);
+
 public:
     /*
     Test the function of the class.
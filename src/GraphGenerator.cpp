@@ -0,0 +1,64 @@
+#include "GraphGenerator.h"
+#include "Random.h"
+
+using sl::GraphGenerator;
+using sl::Graph;
+using sl::Random;
+using std::vector;
+
+void GraphGenerator::grid(const num_type rows, const num_type cols,
+                          const unsigned minW, const unsigned maxW,
+                          vector<Graph::Edge> &edges) {
+    edges.clear();
+    auto random = Random::getInstance();
+    for (num_type r = 0; r < rows; ++r) {
+        for (num_type c = 0; c < cols; ++c) {
+            num_type v = r * cols + c;
+            if (c + 1 < cols) {
+                weight_type w = (weight_type)random->randInt(minW, maxW);
+                edges.push_back(Graph::Edge(v, v + 1, w));
+                edges.push_back(Graph::Edge(v + 1, v, w));
+            }
+            if (r + 1 < rows) {
+                weight_type w = (weight_type)random->randInt(minW, maxW);
+                edges.push_back(Graph::Edge(v, v + cols, w));
+                edges.push_back(Graph::Edge(v + cols, v, w));
+            }
+        }
+    }
+}
+
+void GraphGenerator::rmat(const unsigned scale, const unsigned edgeFactor,
+                          const unsigned minW, const unsigned maxW,
+                          const bool undirected, vector<Graph::Edge> &edges) {
+    const double A = 0.57, B = 0.19, C = 0.19;
+    edges.clear();
+    auto random = Random::getInstance();
+    unsigned long long m = (unsigned long long)edgeFactor << scale;
+    for (unsigned long long i = 0; i < m; ++i) {
+        num_type from = 0, to = 0;
+        for (unsigned bit = 0; bit < scale; ++bit) {
+            double p = random->rand();
+            from <<= 1;
+            to <<= 1;
+            if (p < A) {
+                // Top left quadrant
+            } else if (p < A + B) {
+                to |= 1;
+            } else if (p < A + B + C) {
+                from |= 1;
+            } else {
+                from |= 1;
+                to |= 1;
+            }
+        }
+        if (from == to) {
+            continue;
+        }
+        weight_type w = (weight_type)random->randInt(minW, maxW);
+        edges.push_back(Graph::Edge(from, to, w));
+        if (undirected) {
+            edges.push_back(Graph::Edge(to, from, w));
+        }
+    }
+}
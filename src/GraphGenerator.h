@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Base.h"
+#include "Graph.h"
+#include <vector>
+
+NS_BEGIN
+
+/*
+Generate edge lists of synthetic graphs for testing and
+benchmarking. Weights are drawn from Random.
+
+The edge lists can be loaded into a CSRGraph directly, or
+into a Graph with addEdge().
+*/
+class GraphGenerator {
+public:
+    typedef Graph::num_type num_type;
+    typedef Graph::weight_type weight_type;
+
+    /*
+    Forbid construction, all members are static.
+    */
+    GraphGenerator() = delete;
+
+    /*
+    Road-like graph: a rows x cols grid where each node links
+    to its 4 neighbours in both directions with the same weight.
+    Node (r, c) has number r * cols + c.
+
+    @param rows the number of rows
+    @param cols the number of columns
+    @param minW the minimum weight
+    @param maxW the maximum weight
+    @param edges the result will be stored in this field
+    */
+    static void grid(const num_type rows, const num_type cols,
+                     const unsigned minW, const unsigned maxW,
+                     std::vector<Graph::Edge> &edges);
+
+    /*
+    Power-law graph with the R-MAT model (a = 0.57, b = c = 0.19).
+    Each edge falls recursively into one quadrant of the adjacent
+    matrix, which gives a skewed degree distribution. Self loops
+    are dropped, parallel edges may exist.
+
+    @param scale the graph has 2^scale nodes
+    @param edgeFactor the graph has about edgeFactor * 2^scale edges
+    @param minW the minimum weight
+    @param maxW the maximum weight
+    @param undirected add each edge in both directions if true
+    @param edges the result will be stored in this field
+    */
+    static void rmat(const unsigned scale, const unsigned edgeFactor,
+                     const unsigned minW, const unsigned maxW,
+                     const bool undirected, std::vector<Graph::Edge> &edges);
+};
+
+NS_END
@@ -0,0 +1,109 @@
+#include "HazardPointer.h"
+#include <algorithm>
+#include <mutex>
+
+using sl::HazardPointer;
+using std::vector;
+
+std::atomic<HazardPointer::Record*> HazardPointer::records(nullptr);
+
+namespace {
+// Retired pointers left by exited threads
+std::mutex orphanLock;
+vector<std::pair<void*, void (*)(void *)>> orphans;
+}
+
+HazardPointer::Record::Record() : active(true), next(nullptr) {
+    for (auto &slot : slots) {
+        slot.store(nullptr);
+    }
+}
+
+HazardPointer::ThreadData::ThreadData() : rec(nullptr) {
+    // Reuse a record released by an exited thread
+    for (auto r = records.load(); r; r = r->next) {
+        bool expected = false;
+        if (!r->active.load() && r->active.compare_exchange_strong(expected, true)) {
+            rec = r;
+            return;
+        }
+    }
+    rec = new Record();
+    auto head = records.load();
+    do {
+        rec->next = head;
+    } while (!records.compare_exchange_weak(head, rec));
+}
+
+HazardPointer::ThreadData::~ThreadData() {
+    for (auto &slot : rec->slots) {
+        slot.store(nullptr);
+    }
+    scan(retired);
+    if (!retired.empty()) {
+        std::lock_guard<std::mutex> guard(orphanLock);
+        for (const auto &r : retired) {
+            orphans.push_back(std::make_pair(r.p, r.deleter));
+        }
+    }
+    rec->active.store(false);
+}
+
+HazardPointer::ThreadData& HazardPointer::localData() {
+    static thread_local ThreadData data;
+    return data;
+}
+
+HazardPointer::Record* HazardPointer::localRecord() {
+    return localData().rec;
+}
+
+std::atomic<const void*>* HazardPointer::localSlots() {
+    return localRecord()->slots;
+}
+
+void HazardPointer::clear(const unsigned slot) {
+    localRecord()->slots[slot].store(nullptr);
+}
+
+void HazardPointer::retire(void *p, void (*deleter)(void *)) {
+    auto &retired = localData().retired;
+    retired.push_back(Retired{ p, deleter });
+    if (retired.size() >= SCAN_THRESHOLD) {
+        scan(retired);
+    }
+}
+
+void HazardPointer::scan(vector<Retired> &retired) {
+    // Adopt pointers left by exited threads
+    {
+        std::unique_lock<std::mutex> guard(orphanLock, std::try_to_lock);
+        if (guard.owns_lock()) {
+            for (const auto &o : orphans) {
+                retired.push_back(Retired{ o.first, o.second });
+            }
+            orphans.clear();
+        }
+    }
+    // Collect all the hazard pointers
+    vector<const void*> hazards;
+    for (auto r = records.load(); r; r = r->next) {
+        for (const auto &slot : r->slots) {
+            auto p = slot.load();
+            if (p) {
+                hazards.push_back(p);
+            }
+        }
+    }
+    std::sort(hazards.begin(), hazards.end());
+    // Delete the pointers that are not protected
+    unsigned keep = 0;
+    for (unsigned i = 0; i < retired.size(); ++i) {
+        if (std::binary_search(hazards.begin(), hazards.end(), retired[i].p)) {
+            retired[keep++] = retired[i];
+        } else {
+            retired[i].deleter(retired[i].p);
+        }
+    }
+    retired.resize(keep);
+}
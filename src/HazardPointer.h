@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Base.h"
+#include <atomic>
+#include <vector>
+
+NS_BEGIN
+
+/*
+Hazard pointers for safe memory reclamation in lock-free
+data structures. (Maged M. Michael, 2004)
+
+Before dereferencing a shared node, a thread publishes its
+address in one of its hazard slots. A removed node is retired
+instead of deleted, and it is only released after no thread
+has published its address any more.
+
+Each thread owns SLOTS hazard slots. Records are acquired on
+first use and given back when the thread exits. A data structure
+whose links carry extra bits can store into localSlots() and
+check the link itself, instead of using protect().
+*/
+class HazardPointer {
+public:
+    // Number of hazard slots for each thread
+    // (a skip list search protects a predecessor and a successor per level)
+    static const unsigned SLOTS = 64;
+
+    /*
+    Forbid construction, all members are static.
+    */
+    HazardPointer() = delete;
+
+    /*
+    Load a pointer from an atomic field and protect it.
+
+    @param slot the hazard slot to use, in [0, SLOTS)
+    @param src the atomic field to load from
+    @return the pointer loaded, which is safe to dereference
+            until the slot is cleared or reused
+    */
+    template <typename T>
+    static T* protect(const unsigned slot, const std::atomic<T*> &src) {
+        auto &hazard = localRecord()->slots[slot];
+        T *p = src.load();
+        while (1) {
+            hazard.store(p);
+            T *again = src.load();
+            if (again == p) {
+                return p;
+            }
+            p = again;
+        }
+    }
+
+    /*
+    Return the SLOTS hazard slots of current thread, so that a long
+    search can publish pointers without finding its record each
+    time. A pointer stored in a slot is only safe to dereference if
+    it is found still linked after the store.
+    */
+    static std::atomic<const void*>* localSlots();
+
+    /*
+    Stop protecting the pointer in a slot.
+
+    @param slot the hazard slot to clear
+    */
+    static void clear(const unsigned slot);
+
+    /*
+    Retire a node which has been unlinked from the data structure.
+    It will be deleted after no hazard slot points to it.
+
+    @param p the node to retire
+    */
+    template <typename T>
+    static void retire(T *p) {
+        retire(p, [](void *q) { delete static_cast<T*>(q); });
+    }
+
+    /*
+    Retire a pointer with a custom deleter.
+
+    @param p the pointer to retire
+    @param deleter the function to release the pointer
+    */
+    static void retire(void *p, void (*deleter)(void *));
+
+private:
+    // Scan hazard slots after this amount of nodes retired by a thread
+    static const unsigned SCAN_THRESHOLD = 128;
+
+    /*
+    Hazard slots of one thread.
+    Records are never released, they are reused by new threads.
+    */
+    struct Record {
+        std::atomic<const void*> slots[SLOTS];
+        std::atomic<bool> active;
+        Record *next;
+
+        Record();
+    };
+
+    /*
+    A retired pointer waiting to be deleted.
+    */
+    struct Retired {
+        void *p;
+        void (*deleter)(void *);
+    };
+
+    /*
+    Per thread data, released when the thread exits.
+    */
+    struct ThreadData {
+        Record *rec;
+        std::vector<Retired> retired;
+
+        ThreadData();
+        ~ThreadData();
+    };
+
+    // The list of all hazard records
+    static std::atomic<Record*> records;
+
+    /*
+    Return the hazard record of current thread.
+    */
+    static Record* localRecord();
+
+    /*
+    Return the thread data of current thread.
+    */
+    static ThreadData& localData();
+
+    /*
+    Delete the retired pointers that no hazard slot points to.
+
+    @param retired the retired list, the pointers still
+                   protected will be left in the list
+    */
+    static void scan(std::vector<Retired> &retired);
+};
+
+NS_END
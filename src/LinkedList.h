@@ -114,12 +114,21 @@ public:
     }
 
     /*
-    Sort the list using merge sort algorithm.
+    Sort the list using bottom-up natural merge sort.
+    The sort is stable, non-recursive and allocates no memory.
+    */
+    void sort() {
+        sort(std::less<T>());
+    }
 
-    @param cmp the comparator used in sorting
+    /*
+    Sort the list using bottom-up natural merge sort.
+
+    @param cmp the comparator used in sorting (any callable
+               object with signature bool(const T &a, const T &b))
     */
-    void sort(const std::function<bool(const T &a, const T &b)> &cmp
-              = [](const T &a, const T &b) { return a < b; }) {
+    template <typename Compare>
+    void sort(Compare cmp) {
         head->next = mergeSortList(head->next, cmp);
     }
 
@@ -175,54 +184,77 @@ private:
     }
 
     /*
-    Merge sort for list.
+    Bottom-up natural merge sort for list.
+
+    Ascending runs are cut off the list one by one and merged
+    into an array of run heads like a binary counter, where
+    runs[i] holds a sorted list built from about 2^i runs.
 
     @param h the head of the list to sort
     @param cmp the comparator used in sorting
     @return the new head pointer after sorting
     */
-    ListNode* mergeSortList(ListNode *h,
-                            const std::function<bool(const T &a, const T &b)> &cmp) const {
-        if (!h || !h->next) {
-            return h;
+    template <typename Compare>
+    ListNode* mergeSortList(ListNode *h, Compare &cmp) const {
+        // 64 slots are enough for any list addressable in memory
+        const unsigned MAX_RUNS = 64;
+        ListNode *runs[MAX_RUNS] = { nullptr };
+        unsigned fill = 0;
+        while (h) {
+            // Cut down the next ascending run
+            ListNode *run = h, *tail = h;
+            while (tail->next && !cmp(tail->next->val, tail->val)) {
+                tail = tail->next;
+            }
+            h = tail->next;
+            tail->next = nullptr;
+            // Merge the run into the counter, earlier runs go first
+            unsigned i = 0;
+            for (; i < fill && runs[i]; ++i) {
+                run = mergeTwoList(runs[i], run, cmp);
+                runs[i] = nullptr;
+            }
+            if (i == MAX_RUNS) {
+                --i;
+            }
+            runs[i] = run;
+            if (i == fill) {
+                ++fill;
+            }
         }
-        ListNode *mid = h, *tmp = h->next;
-        while (tmp && tmp->next) {
-            mid = mid->next;
-            tmp = tmp->next->next;
+        ListNode *res = nullptr;
+        for (unsigned i = 0; i < fill; ++i) {
+            if (runs[i]) {
+                res = mergeTwoList(runs[i], res, cmp);
+            }
         }
-        ListNode *firstHalf, *secondHalf;
-        secondHalf = mid->next;
-        mid->next = nullptr;  // Cut down the list into two half
-        firstHalf = mergeSortList(h, cmp);
-        secondHalf = mergeSortList(secondHalf, cmp);
-        return mergeTwoList(firstHalf, secondHalf, cmp);
+        return res;
     }
 
     /*
-    Merge two lists.
+    Merge two sorted lists.
+    Elements of list a go first if they are equal.
 
     @param a the first list
     @param b the second list
     @param cmp the comparator used in sorting
     @return the head of the list after merging
     */
-    ListNode* mergeTwoList(ListNode *a,
-                           ListNode *b,
-                           const std::function<bool(const T &a, const T &b)> &cmp) const {
-        if (!a) {
-            return b;
-        } else if (!b) {
-            return a;
-        }
-        if (!cmp(a->val, b->val)) {
-            ListNode *tmp = b->next;
-            b->next = a;
-            a = b;
-            b = tmp;
+    template <typename Compare>
+    ListNode* mergeTwoList(ListNode *a, ListNode *b, Compare &cmp) const {
+        ListNode *res = nullptr, **tail = &res;
+        while (a && b) {
+            if (cmp(b->val, a->val)) {
+                *tail = b;
+                b = b->next;
+            } else {
+                *tail = a;
+                a = a->next;
+            }
+            tail = &(*tail)->next;
         }
-        a->next = mergeTwoList(a->next, b, cmp);
-        return a;
+        *tail = a ? a : b;
+        return res;
     }
 
 public:
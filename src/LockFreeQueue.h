@@ -0,0 +1,262 @@
+#pragma once
+
+#include "Base.h"
+#include "HazardPointer.h"
+#include "RingBuffer.h"
+#include "Timer.h"
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+NS_BEGIN
+
+/*
+A lock-free multi-producer multi-consumer queue.
+(Michael-Scott queue, 1996)
+
+The nodes have the same layout as LinkedList::ListNode, except
+that the next pointer is atomic. A fake head node is always kept
+in the list: the first element is stored in head->next, and
+the node popped becomes the new fake head.
+
+Removed nodes are released with hazard pointers, so no node is
+deleted while another thread is still reading it.
+
+Type T must be copyable and have a default constructor.
+
+For usage, see function test().
+*/
+template <typename T>
+class LockFreeQueue {
+public:
+    /*
+    Queue node definition.
+    */
+    struct ListNode {
+        T val;
+        std::atomic<ListNode*> next;
+
+        ListNode(const T &v, ListNode *n = nullptr)
+            : val(v), next(n) {}
+    };
+
+    LockFreeQueue() : head(new ListNode(T())) {  // Use fake head
+        tail.store(head.load());
+    }
+
+    /*
+    Release the space.
+    No other thread should access the queue at this time.
+    */
+    ~LockFreeQueue() {
+        ListNode *tmp = head.load(), *del;
+        while (tmp) {
+            del = tmp;
+            tmp = tmp->next.load();
+            delete del;
+        }
+    }
+
+    /*
+    Forbid copy.
+    */
+    LockFreeQueue(const LockFreeQueue<T> &q) = delete;
+    LockFreeQueue<T>& operator=(const LockFreeQueue<T> &q) = delete;
+
+    /*
+    Check whether the queue is empty at the moment.
+    */
+    bool isEmpty() const {
+        auto h = HazardPointer::protect(0, head);
+        bool res = h->next.load() == nullptr;
+        HazardPointer::clear(0);
+        return res;
+    }
+
+    /*
+    Insert an element at the end of the queue.
+
+    @param e the element to insert
+    */
+    void push(const T &e) {
+        auto node = new ListNode(e);
+        while (1) {
+            auto t = HazardPointer::protect(0, tail);
+            auto next = t->next.load();
+            if (t != tail.load()) {
+                continue;
+            }
+            if (next) {
+                // Tail is falling behind, help to move it
+                tail.compare_exchange_weak(t, next);
+            } else if (t->next.compare_exchange_weak(next, node)) {
+                tail.compare_exchange_strong(t, node);
+                break;
+            }
+        }
+        HazardPointer::clear(0);
+    }
+
+    /*
+    Remove an element from the front of the queue.
+
+    @param e the element removed will be stored in this field
+    @return true if an element is removed, false if the queue is empty
+    */
+    bool pop(T &e) {
+        bool res = false;
+        while (1) {
+            auto h = HazardPointer::protect(0, head);
+            auto t = tail.load();
+            auto next = HazardPointer::protect(1, h->next);
+            if (h != head.load()) {
+                continue;
+            }
+            if (!next) {  // Empty queue
+                break;
+            }
+            if (h == t) {
+                // Tail is falling behind, help to move it
+                tail.compare_exchange_weak(t, next);
+                continue;
+            }
+            e = next->val;
+            if (head.compare_exchange_strong(h, next)) {
+                res = true;
+                HazardPointer::clear(0);
+                HazardPointer::retire(h);
+                break;
+            }
+        }
+        HazardPointer::clear(0);
+        HazardPointer::clear(1);
+        return res;
+    }
+
+private:
+    // Keep head and tail on different cache lines
+    alignas(64) std::atomic<ListNode*> head;
+    alignas(64) std::atomic<ListNode*> tail;
+
+    /*
+    Run producers and consumers on a queue and print the throughput.
+
+    @param producers the number of producer threads
+    @param consumers the number of consumer threads
+    @param n the number of elements pushed by each producer
+    @param push push an element, return false if the queue is full
+    @param pop pop an element, return false if the queue is empty
+    @param info the name of the queue
+    */
+    template <typename Push, typename Pop>
+    static void benchmark(const unsigned producers, const unsigned consumers,
+                          const unsigned n, Push push, Pop pop,
+                          const std::string &info) {
+        std::atomic<unsigned long long> popped(0), sum(0);
+        const unsigned long long total = (unsigned long long)producers * n;
+        std::vector<std::thread> threads;
+        Timer timer;
+        for (unsigned i = 0; i < producers; ++i) {
+            threads.push_back(std::thread([&]() {
+                for (unsigned j = 1; j <= n; ++j) {
+                    while (!push(T(j))) {
+                        std::this_thread::yield();
+                    }
+                }
+            }));
+        }
+        for (unsigned i = 0; i < consumers; ++i) {
+            threads.push_back(std::thread([&]() {
+                T tmp;
+                unsigned long long localSum = 0;
+                while (popped.load() < total) {
+                    if (pop(tmp)) {
+                        ++popped;
+                        localSum += tmp;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                sum += localSum;
+            }));
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        auto time = timer.elapse();
+        bool correct = sum.load() == (unsigned long long)producers * n * (n + 1) / 2;
+        printf("%25s: %8.2lf ms, %8.2lf ops/us, check %s\n", info.c_str(),
+               time, time > 0 ? total / time / 1000 : 0, correct ? "pass" : "failed");
+    }
+
+public:
+    /*
+    Test the function of the class.
+    Compare the throughput with a std::queue guarded by a mutex
+    and, for one producer and one consumer, with a RingBuffer.
+    (T must be an integer type)
+
+    Sample #1:
+    4 4 100000
+    */
+    static void test() {
+        std::cout << "Test LockFreeQueue:\n\n";
+        std::cin.clear();
+        unsigned producers, consumers, n;
+        std::cout << "Input producers number, consumers number and elements per producer: ";
+        std::cin >> producers >> consumers >> n;
+        std::cout << std::endl;
+        for (int round = 0; round < 2; ++round) {
+            if (round == 1) {
+                if (producers == 1 && consumers == 1) {
+                    break;
+                }
+                producers = consumers = 1;
+            }
+            printf("%u producer(s), %u consumer(s), %u elements per producer:\n",
+                   producers, consumers, n);
+            {
+                std::queue<T> locked;
+                std::mutex lock;
+                benchmark(producers, consumers, n, [&](const T &e) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    locked.push(e);
+                    return true;
+                }, [&](T &e) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (locked.empty()) {
+                        return false;
+                    }
+                    e = locked.front();
+                    locked.pop();
+                    return true;
+                }, "mutex + std::queue");
+            }
+            {
+                LockFreeQueue<T> q;
+                benchmark(producers, consumers, n, [&](const T &e) {
+                    q.push(e);
+                    return true;
+                }, [&](T &e) {
+                    return q.pop(e);
+                }, "LockFreeQueue");
+            }
+            if (producers == 1 && consumers == 1) {
+                RingBuffer<T> q(1024);
+                benchmark(producers, consumers, n, [&](const T &e) {
+                    return q.push(e);
+                }, [&](T &e) {
+                    return q.pop(e);
+                }, "RingBuffer");
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+NS_END
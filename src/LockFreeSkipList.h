@@ -0,0 +1,563 @@
+#pragma once
+
+#include "Base.h"
+#include "HazardPointer.h"
+#include "Random.h"
+#include "Timer.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+NS_BEGIN
+
+/*
+A lock-free skip list used as a concurrent ordered set.
+(Herlihy and Shavit, The Art of Multiprocessor Programming, 14.4)
+
+All the operations can be called from different threads at
+the same time. Insert and remove link and unlink nodes with CAS
+level by level. A node is removed logically by marking the
+lowest bit of its next pointers, from the top level down to the
+bottom one; the node marked at the bottom level belongs to the
+thread that marked it.
+
+Memory is reclaimed with HazardPointer. A search publishes the
+predecessor and the successor it holds at each level, and checks
+that the link to a node is still there and unmarked before it
+reads the node. Searches never walk through a marked node, they
+unlink it first, or start over if their predecessor is marked.
+A removed node is retired once it is unlinked from every level
+and its inserter has finished linking it, so that no link to it
+can appear again.
+
+has(), min(), max() and the traversals are lock-free. The
+traversals are weakly consistent: they see each element at most
+once, but may miss concurrent changes. They copy the elements in
+batches, and call the function outside of the search, so the
+function may use the list too.
+
+Type T must be copyable, and overload:
+1. operator <  for comparing.
+2. operator << for running test. (not compulsory)
+
+For usage, see function test().
+*/
+template <typename T>
+class LockFreeSkipList {
+public:
+    // Max level of the nodes
+    static const int MAX_LEVEL = 32;
+
+    static_assert(2 * MAX_LEVEL <= (int)HazardPointer::SLOTS,
+                  "LockFreeSkipList: not enough hazard slots for a search");
+
+    LockFreeSkipList() : size_(0), head(createNode(T(), MAX_LEVEL)) {  // Use fake head
+    }
+
+    /*
+    Release the space.
+    No other thread should access the list at this time.
+    */
+    ~LockFreeSkipList() {
+        ListNode *tmp = head, *del;
+        while (tmp) {
+            del = tmp;
+            tmp = getPtr(tmp->next[0].load());
+            if (!isMarked(del->next[0].load())) {  // Marked nodes are retired
+                destroyNode(del);
+            }
+        }
+    }
+
+    /*
+    Forbid copy.
+    */
+    LockFreeSkipList(const LockFreeSkipList<T> &l) = delete;
+    LockFreeSkipList<T>& operator=(const LockFreeSkipList<T> &l) = delete;
+
+    /*
+    Return the number of elements in the list at the moment.
+    */
+    unsigned long long size() const {
+        return size_.load();
+    }
+
+    /*
+    Return whether the list is empty at the moment.
+    */
+    bool isEmpty() const {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        search([](const ListNode*) { return false; }, preds, succs);
+        return succs[0] == nullptr;
+    }
+
+    /*
+    Check if element ele is in the list.
+
+    @param ele the element to check.
+    @return true if the element is in the list, false otherwise.
+    */
+    bool has(const T &ele) const {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        return find(ele, preds, succs);
+    }
+
+    /*
+    Return the minimum element of the list.
+    */
+    T min() const {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        search([](const ListNode*) { return false; }, preds, succs);
+        if (!succs[0]) {
+            throw std::range_error("LockFreeSkipList.min(): list is empty");
+        }
+        return succs[0]->val;
+    }
+
+    /*
+    Return the maximum element of the list.
+    */
+    T max() const {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        search([](const ListNode*) { return true; }, preds, succs);
+        if (preds[0] == head) {
+            throw std::range_error("LockFreeSkipList.max(): list is empty");
+        }
+        return preds[0]->val;
+    }
+
+    /*
+    Insert an element into the list.
+    If the element exists, do nothing.
+
+    @param ele the element to insert.
+    @return true if the element is inserted, false if it exists.
+    */
+    bool insert(const T &ele) {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        int lv = randomLevel();
+        ListNode *node = nullptr;
+        while (1) {
+            if (find(ele, preds, succs)) {
+                if (node) {
+                    destroyNode(node);
+                }
+                return false;
+            }
+            if (!node) {
+                node = createNode(ele, lv);
+            }
+            for (int i = 0; i < lv; ++i) {
+                node->next[i].store(toWord(succs[i]));
+            }
+            // Link the bottom level, then the element is in the set
+            auto expected = toWord(succs[0]);
+            if (preds[0]->next[0].compare_exchange_strong(expected, toWord(node))) {
+                break;
+            }
+        }
+        ++size_;
+        // Link the upper levels, stop if removed by another thread
+        bool removed = false;
+        for (int i = 1; i < lv && !removed; ++i) {
+            while (1) {
+                auto next = node->next[i].load();
+                if (isMarked(next)) {
+                    removed = true;
+                    break;
+                }
+                if (getPtr(next) != succs[i]
+                    && !node->next[i].compare_exchange_strong(next, toWord(succs[i]))) {
+                    removed = true;  // Marked by another thread
+                    break;
+                }
+                auto expected = toWord(succs[i]);
+                if (preds[i]->next[i].compare_exchange_strong(expected, toWord(node))) {
+                    break;
+                }
+                find(ele, preds, succs);
+                if (succs[0] != node) {
+                    removed = true;
+                    break;
+                }
+            }
+        }
+        // A level may have been linked after the remover unlinked the node
+        if (isMarked(node->next[0].load())) {
+            unlink(node);
+        }
+        release(node);
+        return true;
+    }
+
+    /*
+    Remove an element from the list.
+
+    @param ele the element to remove.
+    @return true if the element is removed by this call,
+            false if not found.
+    */
+    bool remove(const T &ele) {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        if (!find(ele, preds, succs)) {
+            return false;
+        }
+        auto node = succs[0];
+        // Mark the upper levels
+        for (int i = node->level - 1; i >= 1; --i) {
+            auto next = node->next[i].load();
+            while (!isMarked(next)) {
+                node->next[i].compare_exchange_weak(next, next | 1);
+            }
+        }
+        // Mark the bottom level, the winner owns the node
+        auto next = node->next[0].load();
+        while (!isMarked(next)) {
+            if (node->next[0].compare_exchange_weak(next, next | 1)) {
+                --size_;
+                unlink(node);
+                release(node);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    Traverse the elements in ascending order.
+
+    @param f the function to manipulate each element
+    */
+    void traverse(const std::function<void(const T&)> &f) const {
+        visit(nullptr, [&](const T &e) {
+            f(e);
+            return true;
+        });
+    }
+
+    /*
+    Traverse the elements in range [low, high] in ascending order.
+
+    @param low the lower bound of the range
+    @param high the upper bound of the range
+    @param f the function to manipulate each element
+    */
+    void traverseInRange(const T &low, const T &high,
+                         const std::function<void(const T&)> &f) const {
+        visit(&low, [&](const T &e) {
+            if (high < e) {
+                return false;
+            }
+            f(e);
+            return true;
+        });
+    }
+
+private:
+    // Number of elements copied by a traversal between two searches
+    static const unsigned VISIT_BATCH = 64;
+
+    /*
+    Definition of the list node.
+    The lowest bit of a next pointer is the removed mark.
+    The next pointers are allocated together with the node.
+    */
+    struct ListNode {
+        T val;
+        int level;
+        std::atomic<int> refs;  // Held by the list and by the inserter
+        std::atomic<uintptr_t> next[1];
+    };
+
+    std::atomic<unsigned long long> size_;
+
+    ListNode *head;
+
+    static ListNode* getPtr(const uintptr_t w) {
+        return reinterpret_cast<ListNode*>(w & ~(uintptr_t)1);
+    }
+
+    static bool isMarked(const uintptr_t w) {
+        return (w & 1) != 0;
+    }
+
+    static uintptr_t toWord(const ListNode *p) {
+        return reinterpret_cast<uintptr_t>(p);
+    }
+
+    /*
+    Allocate a node with its next pointers.
+
+    @param v the value of the node
+    @param lv the level of the node
+    @return the node created
+    */
+    static ListNode* createNode(const T &v, const int lv) {
+        void *mem = ::operator new(sizeof(ListNode) + (lv - 1) * sizeof(std::atomic<uintptr_t>));
+        auto node = static_cast<ListNode*>(mem);
+        new (&node->val) T(v);
+        node->level = lv;
+        new (&node->refs) std::atomic<int>(2);
+        for (int i = 0; i < lv; ++i) {
+            new (&node->next[i]) std::atomic<uintptr_t>(0);
+        }
+        return node;
+    }
+
+    /*
+    Release a node created by createNode().
+    */
+    static void destroyNode(ListNode *node) {
+        node->val.~T();
+        ::operator delete(node);
+    }
+
+    static void deleteNode(void *p) {
+        destroyNode(static_cast<ListNode*>(p));
+    }
+
+    /*
+    Drop a reference to a linked node. The last one, from either the
+    remover or the inserter, retires the node.
+    */
+    static void release(ListNode *node) {
+        if (node->refs.fetch_sub(1) == 1) {
+            HazardPointer::retire(node, deleteNode);
+        }
+    }
+
+    /*
+    Return a random level in [1, MAX_LEVEL]
+    with P(level > i) = 2^(-i).
+
+    Random is not thread-safe, so each thread uses its own
+    xorshift generator seeded from Random once.
+    */
+    static int randomLevel() {
+        static std::mutex seedLock;
+        static thread_local unsigned long long state = 0;
+        if (state == 0) {
+            std::lock_guard<std::mutex> guard(seedLock);
+            state = Random::getInstance()->randInt(1, 2147483646ULL) << 32
+                | Random::getInstance()->randInt(1, 2147483646ULL);
+        }
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int lv = 1;
+        for (auto bits = state; lv < MAX_LEVEL && (bits & 1); bits >>= 1) {
+            ++lv;
+        }
+        return lv;
+    }
+
+    /*
+    Search each level from the top, moving right while goRight
+    returns true for the next node, and unlink the marked nodes
+    on the way. The nodes found stay protected by the hazard
+    slots of current thread until its next search.
+
+    Level i uses hazard slots 2i and 2i+1 in turn: the node moved
+    to stays in its slot as the predecessor, the next node goes
+    to the other one.
+
+    @param goRight whether to move past a node
+    @param preds the last node passed at each level will be stored in this field
+    @param succs the node after it at each level will be stored in this field
+    */
+    template <typename GoRight>
+    void search(GoRight goRight, ListNode **preds, ListNode **succs) const {
+        auto hazards = HazardPointer::localSlots();
+    retry:
+        ListNode *pred = head;
+        for (int i = MAX_LEVEL - 1; i >= 0; --i) {
+            unsigned predSlot = 2 * i;
+            hazards[predSlot].store(pred);  // Still held by a slot of level i + 1
+            ListNode *curr = nullptr;
+            while (1) {
+                auto w = pred->next[i].load();
+                if (isMarked(w)) {
+                    goto retry;  // pred is being removed
+                }
+                curr = getPtr(w);
+                hazards[predSlot ^ 1].store(curr);
+                if (pred->next[i].load() != w) {
+                    continue;  // Changed before it was protected
+                }
+                if (!curr) {
+                    break;
+                }
+                auto succ = curr->next[i].load();
+                if (isMarked(succ)) {
+                    // Unlink the marked node, then read pred again
+                    pred->next[i].compare_exchange_strong(w, toWord(getPtr(succ)));
+                    continue;
+                }
+                if (!goRight(curr)) {
+                    break;
+                }
+                pred = curr;
+                predSlot ^= 1;
+            }
+            preds[i] = pred;
+            succs[i] = curr;
+        }
+    }
+
+    /*
+    Find the last node smaller than an element and its successor
+    at each level, and unlink the marked nodes on the way.
+
+    @param ele the element to find
+    @param preds the predecessors will be stored in this field
+    @param succs the successors will be stored in this field
+    @return true if the element is in the list
+    */
+    bool find(const T &ele, ListNode **preds, ListNode **succs) const {
+        search([&](const ListNode *curr) { return curr->val < ele; }, preds, succs);
+        return succs[0] && !(ele < succs[0]->val);
+    }
+
+    /*
+    Unlink a marked node from every level. Nodes equal to it that
+    were inserted later are passed, so it is found at each level.
+    */
+    void unlink(const ListNode *node) const {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        const T &ele = node->val;
+        search([&](const ListNode *curr) {
+            return curr->val < ele || (!(ele < curr->val) && curr != node);
+        }, preds, succs);
+    }
+
+    /*
+    Copy the elements not smaller than low in ascending order, a batch
+    at a time, and pass them to f until it returns false.
+
+    @param low the lower bound, nullptr for all the elements
+    @param f the function to receive the elements
+    */
+    template <typename Receive>
+    void visit(const T *low, Receive f) const {
+        ListNode *preds[MAX_LEVEL], *succs[MAX_LEVEL];
+        if (low) {
+            find(*low, preds, succs);
+        } else {
+            search([](const ListNode*) { return false; }, preds, succs);
+        }
+        auto hazards = HazardPointer::localSlots();
+        std::vector<T> batch;
+        while (1) {
+            batch.clear();
+            // Walk the bottom level hand over hand from the search result,
+            // which is in slot 0 or 1
+            ListNode *curr = succs[0];
+            unsigned currSlot = hazards[0].load() == curr ? 0 : 1;
+            bool end = curr == nullptr;
+            while (curr && batch.size() < VISIT_BATCH) {
+                batch.push_back(curr->val);
+                auto pred = curr;
+                currSlot ^= 1;
+                while (1) {
+                    auto w = pred->next[0].load();
+                    if (isMarked(w)) {
+                        curr = nullptr;  // pred is being removed, search again
+                        break;
+                    }
+                    curr = getPtr(w);
+                    hazards[currSlot].store(curr);
+                    if (pred->next[0].load() != w) {
+                        continue;
+                    }
+                    if (!curr) {
+                        end = true;
+                        break;
+                    }
+                    auto succ = curr->next[0].load();
+                    if (isMarked(succ)) {
+                        pred->next[0].compare_exchange_strong(w, toWord(getPtr(succ)));
+                        continue;
+                    }
+                    break;
+                }
+            }
+            for (const auto &e : batch) {
+                if (!f(e)) {
+                    return;
+                }
+            }
+            if (end) {
+                return;
+            }
+            // Continue after the last element copied
+            const T &last = batch.back();
+            search([&](const ListNode *node) { return !(last < node->val); }, preds, succs);
+        }
+    }
+
+public:
+    /*
+    Test the function of the class.
+    Insert, find and remove random elements with different
+    numbers of threads, then check the content.
+    (T must be an integer type)
+
+    Sample #1:
+    4 200000
+    */
+    static void test() {
+        std::cout << "Test LockFreeSkipList:\n\n";
+        std::cin.clear();
+        unsigned maxThreads, n;
+        std::cout << "Input max threads number and elements per thread: ";
+        std::cin >> maxThreads >> n;
+        std::cout << std::endl;
+        for (unsigned threadNum = 1; threadNum <= maxThreads; threadNum <<= 1) {
+            LockFreeSkipList<T> list;
+            std::vector<std::thread> threads;
+            Timer timer;
+            for (unsigned t = 0; t < threadNum; ++t) {
+                threads.push_back(std::thread([&list, t, threadNum, n]() {
+                    // Thread t owns the elements e with e % threadNum == t
+                    for (unsigned i = 0; i < n; ++i) {
+                        list.insert(T((i * 2654435761ULL % n) * threadNum + t));
+                    }
+                    for (unsigned i = 0; i < n; ++i) {
+                        list.has(T(i * threadNum + t));
+                    }
+                    for (unsigned i = 0; i < n; i += 2) {
+                        list.remove(T(i * threadNum + t));
+                    }
+                }));
+            }
+            for (auto &t : threads) {
+                t.join();
+            }
+            auto time = timer.elapse();
+            // Odd positions of each thread are left
+            unsigned long long cnt = 0;
+            bool correct = true;
+            T last = T();
+            list.traverse([&](const T &e) {
+                if ((cnt > 0 && !(last < e)) || (e / threadNum) % 2 == 0) {
+                    correct = false;
+                }
+                last = e;
+                ++cnt;
+            });
+            correct = correct && cnt == list.size()
+                && cnt == (unsigned long long)threadNum * (n / 2);
+            printf("%2u thread(s): %8.2lf ms, %8.2lf ops/us, check %s\n", threadNum,
+                   time, 2.5 * n * threadNum / time / 1000, correct ? "pass" : "failed");
+        }
+    }
+};
+
+NS_END
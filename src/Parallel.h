@@ -0,0 +1,194 @@
+#pragma once
+
+#include "Base.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+NS_BEGIN
+
+/*
+Helpers to run loops on multiple threads.
+
+A thread number of 0 means using all the hardware threads.
+The calling thread always works as thread 0, so nothing is
+created when only one thread is used.
+
+An algorithm with many short rounds should start its threads
+once with run() and separate the rounds with a Barrier, instead
+of calling forChunks() for each round. Inside a round, the
+threads share the work with takeChunks(). Rounds of one chunk are
+better done by thread 0 alone while the others wait.
+*/
+class Parallel {
+public:
+    /*
+    Forbid construction, all members are static.
+    */
+    Parallel() = delete;
+
+    /*
+    A reusable barrier for a fixed number of threads.
+    A waiting thread yields for a while before it sleeps, as the
+    rounds between two barriers are often short.
+    */
+    class Barrier {
+    public:
+        /*
+        @param n the number of threads which wait at the barrier
+        */
+        Barrier(const unsigned n) : count(n), waiting(0), generation(0) {}
+
+        Barrier(const Barrier &b) = delete;
+        Barrier& operator=(const Barrier &b) = delete;
+
+        /*
+        Block until all the threads have called wait() in this round.
+        */
+        void wait() {
+            if (count <= 1) {
+                return;
+            }
+            auto gen = generation.load(std::memory_order_acquire);
+            if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+                waiting.store(0, std::memory_order_relaxed);
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    generation.store(gen + 1, std::memory_order_release);
+                }
+                cond.notify_all();
+                return;
+            }
+            for (unsigned i = 0; i < SPIN; ++i) {
+                if (generation.load(std::memory_order_acquire) != gen) {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+            std::unique_lock<std::mutex> guard(lock);
+            cond.wait(guard, [&]() { return generation.load(std::memory_order_acquire) != gen; });
+        }
+
+    private:
+        static const unsigned SPIN = 1000;  // Yields before sleeping
+
+        const unsigned count;
+        std::atomic<unsigned> waiting;
+        std::atomic<unsigned long long> generation;
+        std::mutex lock;
+        std::condition_variable cond;
+    };
+
+    /*
+    Return the number of hardware threads (at least 1).
+    */
+    static unsigned hardwareThreads() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    /*
+    Return the real thread number to use.
+
+    @param threadNum the thread number required, 0 for all hardware threads
+    */
+    static unsigned threadCount(const unsigned threadNum) {
+        return threadNum == 0 ? hardwareThreads() : threadNum;
+    }
+
+    /*
+    Call f(threadId) on each thread and wait for all of them.
+
+    @param threadNum the number of threads
+    @param f the function to run, threadId is in [0, threadNum)
+    */
+    template <typename F>
+    static void run(const unsigned threadNum, F f) {
+        unsigned n = threadCount(threadNum);
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < n; ++i) {
+            threads.push_back(std::thread(f, i));
+        }
+        f(0);
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+
+    /*
+    Split [begin, end) into chunks of grain indices, and call
+    f(threadId, lo, hi) for each chunk [lo, hi) on multiple threads.
+    Threads take the next chunk when they finish one.
+
+    @param begin the first index
+    @param end the index after the last one
+    @param f the function to call on each chunk
+    @param threadNum the number of threads
+    @param grain the number of indices in a chunk
+    */
+    template <typename F>
+    static void forChunks(const unsigned long long begin, const unsigned long long end,
+                          F f, const unsigned threadNum = 0,
+                          const unsigned long long grain = 1024) {
+        if (begin >= end) {
+            return;
+        }
+        unsigned n = threadCount(threadNum);
+        n = (unsigned)std::min<unsigned long long>(n, (end - begin + grain - 1) / grain);
+        std::atomic<unsigned long long> next(begin);
+        run(n, [&](unsigned t) {
+            takeChunks(next, end, [&](unsigned long long lo, unsigned long long hi) {
+                f(t, lo, hi);
+            }, grain);
+        });
+    }
+
+    /*
+    Take chunks of grain indices from a counter shared by the threads
+    of run(), and call f(lo, hi) for each chunk [lo, hi) until the
+    counter reaches end. The counter must be set to the first index
+    before any thread takes from it, e.g. between two barriers.
+
+    @param next the index of the next chunk
+    @param end the index after the last one
+    @param f the function to call on each chunk
+    @param grain the number of indices in a chunk
+    */
+    template <typename F>
+    static void takeChunks(std::atomic<unsigned long long> &next, const unsigned long long end,
+                           F f, const unsigned long long grain = 1024) {
+        while (1) {
+            auto lo = next.fetch_add(grain);
+            if (lo >= end) {
+                break;
+            }
+            f(lo, std::min(end, lo + grain));
+        }
+    }
+
+    /*
+    Call f(i) for each i in [begin, end) on multiple threads.
+    Threads take chunks of grain indices at a time.
+
+    @param begin the first index
+    @param end the index after the last one
+    @param f the function to call on each index
+    @param threadNum the number of threads
+    @param grain the number of indices taken at a time
+    */
+    template <typename F>
+    static void forRange(const unsigned long long begin, const unsigned long long end,
+                         F f, const unsigned threadNum = 0,
+                         const unsigned long long grain = 1024) {
+        forChunks(begin, end, [&](unsigned, unsigned long long lo, unsigned long long hi) {
+            for (auto i = lo; i < hi; ++i) {
+                f(i);
+            }
+        }, threadNum, grain);
+    }
+};
+
+NS_END
@@ -0,0 +1,382 @@
+#include "PointToPointQuery.h"
+#include "AlgorithmGraph.h"
+#include "GraphGenerator.h"
+#include "Random.h"
+#include "Timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <stdexcept>
+
+using sl::PointToPointQuery;
+using sl::AlgorithmGraph;
+using sl::CSRGraph;
+using sl::Graph;
+using sl::GraphGenerator;
+using sl::Random;
+using sl::Timer;
+using std::cout;
+using std::cin;
+using std::endl;
+using std::vector;
+using std::string;
+
+const PointToPointQuery::weight_type PointToPointQuery::INF = 2147483647;
+
+namespace {
+// Magic bytes at the beginning of a landmark file
+const char LANDMARK_MAGIC[8] = { 'S', 'L', 'A', 'L', 'T', 'v', '1', 0 };
+}
+
+void PointToPointQuery::SearchState::init(const num_type n) {
+    stamp.assign(n, 0);
+    doneStamp.assign(n, 0);
+    dist.assign(n, INF);
+    prev.assign(n, 0);
+    generation = 0;
+}
+
+void PointToPointQuery::SearchState::reset() {
+    if (++generation == 0) {  // Wrap around, clear all stamps once
+        std::fill(stamp.begin(), stamp.end(), 0);
+        std::fill(doneStamp.begin(), doneStamp.end(), 0);
+        generation = 1;
+    }
+}
+
+bool PointToPointQuery::SearchState::reached(const index_type v) const {
+    return stamp[v] == generation;
+}
+
+bool PointToPointQuery::SearchState::done(const index_type v) const {
+    return doneStamp[v] == generation;
+}
+
+void PointToPointQuery::SearchState::reach(const index_type v, const weight_type d,
+                                           const index_type p) {
+    stamp[v] = generation;
+    dist[v] = d;
+    prev[v] = p;
+}
+
+PointToPointQuery::PointToPointQuery(const CSRGraph &g_)
+    : g(g_), rg(g_.transpose()), heuristic(g_.size(), 0) {
+    forward.init(g.size());
+    backward.init(g.size());
+}
+
+PointToPointQuery::~PointToPointQuery() {
+}
+
+void PointToPointQuery::checkValid(const num_type &n) const {
+    if (n < 0 || n >= g.size()) {
+        throw std::range_error("PointToPointQuery.checkValid(): node number is not valid");
+    }
+}
+
+void PointToPointQuery::buildPath(const index_type meet, Route &res,
+                                  const bool withBackward) const {
+    res.path.clear();
+    for (auto v = meet; ; v = forward.prev[v]) {
+        res.path.push_back(v);
+        if (forward.prev[v] == v) {
+            break;
+        }
+    }
+    std::reverse(res.path.begin(), res.path.end());
+    if (withBackward) {
+        for (auto v = meet; backward.prev[v] != v; ) {
+            v = backward.prev[v];
+            res.path.push_back(v);
+        }
+    }
+}
+
+PointToPointQuery::Route PointToPointQuery::bidirectional(const num_type &src, const num_type &des) {
+    typedef std::pair<weight_type, index_type> heap_node;
+    typedef std::priority_queue<heap_node, vector<heap_node>, std::greater<heap_node>> heap_type;
+    checkValid(src);
+    checkValid(des);
+    Route res;
+    res.dist = INF;
+    res.settled = 0;
+    forward.reset();
+    backward.reset();
+    auto s = (index_type)src, t = (index_type)des;
+    forward.reach(s, 0, s);
+    backward.reach(t, 0, t);
+    index_type meet = s;
+    if (s == t) {
+        res.dist = 0;
+    }
+    heap_type qf, qb;
+    qf.push(heap_node(0, s));
+    qb.push(heap_node(0, t));
+    while (!qf.empty() && !qb.empty()) {
+        if (qf.top().first + qb.top().first >= res.dist) {
+            break;  // No shorter path through unsettled nodes
+        }
+        bool isForward = qf.size() <= qb.size();
+        auto &q = isForward ? qf : qb;
+        auto &self = isForward ? forward : backward;
+        auto &other = isForward ? backward : forward;
+        const auto &graph = isForward ? g : rg;
+        auto d = q.top().first;
+        auto u = q.top().second;
+        q.pop();
+        if (self.done(u)) {
+            continue;  // Outdated heap node
+        }
+        self.doneStamp[u] = self.generation;
+        ++res.settled;
+        const auto &offs = graph.offsets();
+        const auto &tgts = graph.targets();
+        const auto &wts = graph.weights();
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            auto v = tgts[j];
+            auto nd = d + wts[j];
+            if (!self.reached(v) || nd < self.dist[v]) {
+                self.reach(v, nd, u);
+                q.push(heap_node(nd, v));
+                if (other.reached(v) && nd + other.dist[v] < res.dist) {
+                    res.dist = nd + other.dist[v];
+                    meet = v;
+                }
+            }
+        }
+    }
+    if (res.dist < INF) {
+        buildPath(meet, res, true);
+    } else {
+        res.dist = INF;
+    }
+    return res;
+}
+
+PointToPointQuery::weight_type PointToPointQuery::lowerBound(const index_type v,
+                                                             const index_type des) const {
+    const size_t k = landmarks.size();
+    weight_type res = 0;
+    for (size_t i = 0; i < k; ++i) {
+        auto fv = fromLandmark[v * k + i], ft = fromLandmark[des * k + i];
+        auto tv = toLandmark[v * k + i], tt = toLandmark[des * k + i];
+        // L reaches v but not des, or des reaches L but v does not:
+        // then v can not reach des
+        if ((fv < INF && ft >= INF) || (tt < INF && tv >= INF)) {
+            return INF;
+        }
+        if (fv < INF && ft < INF) {
+            res = std::max(res, ft - fv);
+        }
+        if (tv < INF && tt < INF) {
+            res = std::max(res, tv - tt);
+        }
+    }
+    return res;
+}
+
+PointToPointQuery::Route PointToPointQuery::alt(const num_type &src, const num_type &des) {
+    typedef std::pair<weight_type, index_type> heap_node;
+    if (landmarks.empty()) {
+        throw std::range_error("PointToPointQuery.alt(): no landmarks, build or load them first");
+    }
+    checkValid(src);
+    checkValid(des);
+    Route res;
+    res.dist = INF;
+    res.settled = 0;
+    forward.reset();
+    auto s = (index_type)src, t = (index_type)des;
+    const auto &offs = g.offsets();
+    const auto &tgts = g.targets();
+    const auto &wts = g.weights();
+    std::priority_queue<heap_node, vector<heap_node>, std::greater<heap_node>> q;
+    forward.reach(s, 0, s);
+    heuristic[s] = lowerBound(s, t);
+    if (heuristic[s] < INF) {
+        q.push(heap_node(heuristic[s], s));
+    }
+    while (!q.empty()) {
+        auto u = q.top().second;
+        q.pop();
+        if (forward.done(u)) {
+            continue;  // Outdated heap node
+        }
+        forward.doneStamp[u] = forward.generation;
+        ++res.settled;
+        if (u == t) {
+            res.dist = forward.dist[t];
+            buildPath(t, res, false);
+            break;
+        }
+        for (auto j = offs[u]; j < offs[u + 1]; ++j) {
+            auto v = tgts[j];
+            auto nd = forward.dist[u] + wts[j];
+            if (!forward.reached(v)) {
+                heuristic[v] = lowerBound(v, t);
+            } else if (forward.done(v) || nd >= forward.dist[v]) {
+                continue;
+            }
+            forward.reach(v, nd, u);
+            if (heuristic[v] < INF) {
+                q.push(heap_node(nd + heuristic[v], v));
+            }
+        }
+    }
+    return res;
+}
+
+void PointToPointQuery::buildLandmarks(const unsigned k_) {
+    const num_type n = g.size();
+    const size_t k = std::min<size_t>(k_, n);
+    auto algorithmGraph = AlgorithmGraph::getInstance();
+    landmarks.clear();
+    fromLandmark.assign(n * k, INF);
+    toLandmark.assign(n * k, INF);
+    if (k == 0) {
+        return;
+    }
+    // Farthest selection: start from the node farthest from a random node,
+    // then pick the node farthest from all chosen landmarks each time
+    vector<weight_type> score = algorithmGraph->dijkstra(
+        g, (num_type)Random::getInstance()->randInt(0, n - 1)).dist;
+    for (size_t i = 0; i < k; ++i) {
+        num_type next = 0;
+        for (num_type v = 1; v < n; ++v) {
+            if (score[v] > score[next]) {
+                next = v;
+            }
+        }
+        if (i == 0) {
+            // Farthest reachable node, or any node if none reachable
+            next = -1;
+            for (num_type v = 0; v < n; ++v) {
+                if (score[v] < INF && (next < 0 || score[v] > score[next])) {
+                    next = v;
+                }
+            }
+            next = next < 0 ? 0 : next;
+            score.assign(n, INF);
+        }
+        landmarks.push_back(next);
+        auto from = algorithmGraph->dijkstra(g, next).dist;
+        auto to = algorithmGraph->dijkstra(rg, next).dist;
+        for (num_type v = 0; v < n; ++v) {
+            fromLandmark[v * k + i] = from[v];
+            toLandmark[v * k + i] = to[v];
+            score[v] = std::min(score[v], from[v]);
+        }
+        score[next] = -1;  // Never pick it again
+    }
+}
+
+void PointToPointQuery::saveLandmarks(const string &file) const {
+    std::ofstream out(file, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("PointToPointQuery.saveLandmarks(): can not open file");
+    }
+    uint64_t n = g.size(), k = landmarks.size();
+    vector<uint64_t> ids(landmarks.begin(), landmarks.end());
+    out.write(LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    out.write(reinterpret_cast<const char*>(&k), sizeof(k));
+    out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(fromLandmark.data()), fromLandmark.size() * sizeof(weight_type));
+    out.write(reinterpret_cast<const char*>(toLandmark.data()), toLandmark.size() * sizeof(weight_type));
+    if (!out) {
+        throw std::runtime_error("PointToPointQuery.saveLandmarks(): write failed");
+    }
+}
+
+void PointToPointQuery::loadLandmarks(const string &file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("PointToPointQuery.loadLandmarks(): can not open file");
+    }
+    char magic[sizeof(LANDMARK_MAGIC)];
+    uint64_t n = 0, k = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    in.read(reinterpret_cast<char*>(&k), sizeof(k));
+    if (!in || memcmp(magic, LANDMARK_MAGIC, sizeof(magic)) != 0
+        || n != (uint64_t)g.size() || k > n) {
+        throw std::runtime_error("PointToPointQuery.loadLandmarks(): file does not match the graph");
+    }
+    vector<uint64_t> ids(k);
+    vector<weight_type> from(n * k), to(n * k);
+    in.read(reinterpret_cast<char*>(ids.data()), k * sizeof(uint64_t));
+    in.read(reinterpret_cast<char*>(from.data()), from.size() * sizeof(weight_type));
+    in.read(reinterpret_cast<char*>(to.data()), to.size() * sizeof(weight_type));
+    if (!in) {
+        throw std::runtime_error("PointToPointQuery.loadLandmarks(): file is truncated");
+    }
+    for (const auto &id : ids) {
+        if (id >= n) {  // Also catches negative ids written as unsigned
+            throw std::range_error("PointToPointQuery.loadLandmarks(): landmark is not a node of the graph");
+        }
+    }
+    landmarks.assign(ids.begin(), ids.end());
+    fromLandmark.swap(from);
+    toLandmark.swap(to);
+}
+
+const vector<PointToPointQuery::num_type>& PointToPointQuery::getLandmarks() const {
+    return landmarks;
+}
+
+void PointToPointQuery::test() {
+    cout << "Test PointToPointQuery:\n\n";
+    cin.clear();
+    Graph::num_type side;
+    unsigned k, queries;
+    cout << "Input grid side length, landmarks number and queries number: ";
+    cin >> side >> k >> queries;
+    cout << endl;
+    vector<Graph::Edge> edges;
+    GraphGenerator::grid(side, side, 1, 100, edges);
+    CSRGraph csr(side * side, edges);
+    PointToPointQuery p2p(csr);
+    Timer timer;
+    p2p.buildLandmarks(k);
+    printf("Build %u landmarks: %.2lf ms\n", k, timer.elapse());
+    const string file = "landmarks.bin";
+    p2p.saveLandmarks(file);
+    PointToPointQuery loaded(csr);
+    loaded.loadLandmarks(file);
+    std::remove(file.c_str());
+    auto algorithmGraph = AlgorithmGraph::getInstance();
+    auto random = Random::getInstance();
+    double time[3] = { 0, 0, 0 };
+    unsigned long long settled[3] = { 0, 0, 0 };
+    bool correct = true;
+    for (unsigned i = 0; i < queries; ++i) {
+        auto s = (num_type)random->randInt(0, csr.size() - 1);
+        auto t = (num_type)random->randInt(0, csr.size() - 1);
+        timer.reset();
+        auto expected = algorithmGraph->dijkstra(csr, s);
+        time[0] += timer.elapse();
+        settled[0] += csr.size();
+        timer.reset();
+        auto r1 = p2p.bidirectional(s, t);
+        time[1] += timer.elapse();
+        settled[1] += r1.settled;
+        timer.reset();
+        auto r2 = loaded.alt(s, t);
+        time[2] += timer.elapse();
+        settled[2] += r2.settled;
+        correct = correct && r1.dist == expected.dist[t] && r2.dist == expected.dist[t]
+            && r1.path.front() == s && r1.path.back() == t
+            && r2.path.front() == s && r2.path.back() == t;
+    }
+    const char *names[3] = { "dijkstra", "bidirectional", "ALT" };
+    for (int i = 0; i < 3; ++i) {
+        printf("%15s: %8.3lf ms/query, %10.1lf nodes settled/query\n", names[i],
+               time[i] / queries, (double)settled[i] / queries);
+    }
+    printf("Check: %s\n", correct ? "pass" : "failed");
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Base.h"
+#include "CSRGraph.h"
+#include <string>
+#include <vector>
+
+NS_BEGIN
+
+/*
+Point-to-point shortest path queries on a static graph.
+
+Two query algorithms are provided:
+1. Bidirectional Dijkstra: search forward from the source and
+   backward from the target, alternating the side with the smaller
+   heap, and stop when the two heap tops add up to at least the
+   best path found.
+2. ALT (A*, landmarks, triangle inequality): A* search guided by
+   lower bounds from precomputed distances to and from a few
+   landmark nodes. For a landmark L and a node v:
+   dist(v, t) >= dist(L, t) - dist(L, v)
+   dist(v, t) >= dist(v, L) - dist(t, L)
+   Landmarks are picked far apart (farthest selection), and the
+   distance tables can be saved to and loaded from a binary file.
+
+Both only touch the part of the graph they search. The per-node
+arrays are reused between queries and invalidated with a generation
+counter, so a query does not refill them.
+
+Edge weights must be nonnegative. An object can run one query at
+a time; use one object per thread.
+
+For usage, see function test().
+*/
+class PointToPointQuery {
+public:
+    typedef CSRGraph::num_type num_type;
+    typedef CSRGraph::weight_type weight_type;
+
+    // Distance of an unreachable node
+    static const weight_type INF;
+
+    /*
+    Result of a query.
+    */
+    struct Route {
+        weight_type dist;              // Length of the path, INF if unreachable
+        std::vector<num_type> path;    // Nodes from source to target, empty if unreachable
+        unsigned long long settled;    // Number of nodes settled by the search
+    };
+
+    /*
+    Initialize with a graph.
+
+    @param g the graph, which must outlive this object
+    */
+    PointToPointQuery(const CSRGraph &g);
+    ~PointToPointQuery();
+
+    /*
+    Query with bidirectional Dijkstra.
+
+    @param src the source node
+    @param des the target node
+    */
+    Route bidirectional(const num_type &src, const num_type &des);
+
+    /*
+    Query with ALT. Landmarks must be built or loaded first.
+
+    @param src the source node
+    @param des the target node
+    */
+    Route alt(const num_type &src, const num_type &des);
+
+    /*
+    Pick landmarks and compute their distance tables.
+    (time complexity: O(k * (V+E)logV))
+
+    @param k the number of landmarks
+    */
+    void buildLandmarks(const unsigned k);
+
+    /*
+    Save the landmark tables to a binary file.
+
+    @param file the file path
+    @throw std::runtime_error if the file can not be written
+    */
+    void saveLandmarks(const std::string &file) const;
+
+    /*
+    Load the landmark tables from a binary file.
+
+    @param file the file path
+    @throw std::runtime_error if the file can not be read or does
+           not match the graph
+    @throw std::range_error if a landmark is not a node of the graph
+    */
+    void loadLandmarks(const std::string &file);
+
+    /*
+    Return the landmark nodes.
+    */
+    const std::vector<num_type>& getLandmarks() const;
+
+private:
+    typedef CSRGraph::index_type index_type;
+
+    const CSRGraph &g;
+    CSRGraph rg;  // Reverse graph
+
+    // Landmark tables, node major: table[v * k + i] for landmark i
+    std::vector<num_type> landmarks;
+    std::vector<weight_type> fromLandmark;
+    std::vector<weight_type> toLandmark;
+
+    /*
+    Per-node search state of one direction.
+    An entry is valid only if stamp[v] == generation.
+    */
+    struct SearchState {
+        std::vector<unsigned> stamp;
+        std::vector<weight_type> dist;
+        std::vector<index_type> prev;
+        std::vector<unsigned> doneStamp;  // Settled if doneStamp[v] == generation
+        unsigned generation;
+
+        void init(const num_type n);
+        void reset();
+        bool reached(const index_type v) const;
+        bool done(const index_type v) const;
+        void reach(const index_type v, const weight_type d, const index_type p);
+    };
+
+    SearchState forward;
+    SearchState backward;
+
+    // Cached lower bounds of A*
+    std::vector<weight_type> heuristic;
+
+    /*
+    Check if the node number is valid in the graph.
+
+    @throw std::range_error if the node is not valid
+    */
+    void checkValid(const num_type &n) const;
+
+    /*
+    Return a lower bound of dist(v, des) from the landmarks.
+    */
+    weight_type lowerBound(const index_type v, const index_type des) const;
+
+    /*
+    Build the path from prev links of the searches.
+
+    @param meet the node where the path goes through
+    @param res the path will be stored in this field
+    @param withBackward whether to follow the backward search from meet
+    */
+    void buildPath(const index_type meet, Route &res, const bool withBackward) const;
+
+public:
+    /*
+    Test the function of the class.
+    Run random queries on a generated road-like graph, and compare
+    the answers and the settled nodes with a full dijkstra.
+
+    Sample #1:
+    300 8 100
+    */
+    static void test();
+};
+
+NS_END
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Base.h"
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+NS_BEGIN
+
+/*
+A bounded single-producer single-consumer ring buffer.
+
+Exactly one thread may call push() and exactly one thread may
+call pop() at the same time, no lock is needed. The capacity is
+rounded up to a power of two so that positions wrap with a mask.
+
+Each side caches the last position it read from the other side,
+so the shared positions are only reloaded when the buffer looks
+full (for the producer) or empty (for the consumer).
+
+Type T must be copyable and have a default constructor.
+To run test, T must overload operator '<<' and '>>'.
+
+For usage, see function test().
+*/
+template <typename T>
+class RingBuffer {
+public:
+    typedef unsigned long long size_type;
+
+    /*
+    Initialize the buffer.
+
+    @param capacity_ the minimum number of elements the buffer can hold
+    */
+    RingBuffer(const size_type capacity_) : mask(0), arr(),
+        head(0), tailCache(0), tail(0), headCache(0) {
+        if (capacity_ == 0) {
+            throw std::range_error("RingBuffer(): capacity must be positive");
+        }
+        size_type cap = 1;
+        while (cap < capacity_) {
+            cap <<= 1;
+        }
+        mask = cap - 1;
+        arr.resize(cap);
+    }
+
+    /*
+    Forbid copy.
+    */
+    RingBuffer(const RingBuffer<T> &b) = delete;
+    RingBuffer<T>& operator=(const RingBuffer<T> &b) = delete;
+
+    /*
+    Return the number of elements the buffer can hold.
+    */
+    size_type capacity() const {
+        return mask + 1;
+    }
+
+    /*
+    Return the number of elements in the buffer at the moment.
+    */
+    size_type size() const {
+        // Load head first: tail only grows, so it is never behind the head
+        // read before it, but pushes in between may run past the capacity
+        auto h = head.load(std::memory_order_acquire);
+        auto t = tail.load(std::memory_order_acquire);
+        return t - h > mask ? mask + 1 : t - h;
+    }
+
+    /*
+    Return whether the buffer is empty at the moment.
+    */
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /*
+    Insert an element at the end of the buffer. (producer only)
+
+    @param e the element to insert
+    @return true if succeed, false if the buffer is full
+    */
+    bool push(const T &e) {
+        auto t = tail.load(std::memory_order_relaxed);
+        if (t - headCache > mask) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache > mask) {
+                return false;
+            }
+        }
+        arr[t & mask] = e;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+    Remove an element from the front of the buffer. (consumer only)
+
+    @param e the element removed will be stored in this field
+    @return true if succeed, false if the buffer is empty
+    */
+    bool pop(T &e) {
+        auto h = head.load(std::memory_order_relaxed);
+        if (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h == tailCache) {
+                return false;
+            }
+        }
+        e = arr[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    size_type mask;
+    std::vector<T> arr;
+
+    // Consumer side, positions only increase
+    alignas(64) std::atomic<size_type> head;
+    size_type tailCache;
+
+    // Producer side
+    alignas(64) std::atomic<size_type> tail;
+    size_type headCache;
+
+public:
+    /*
+    Test the function of the class.
+    For the throughput, see LockFreeQueue::test().
+
+    Sample #1:
+    push 1
+    push 2
+    push 3
+    push 4
+    push 5
+    pop
+    push 6
+    */
+    static void test() {
+        std::cout << "Test RingBuffer:\n\n";
+        std::cin.clear();
+        RingBuffer<T> buffer(4);
+        T tmp;
+        std::string oper;
+        std::cout << "Operations available:\n"
+            << "1. push x (push element x)\n"
+            << "2. pop    (pop an element)\n"
+            << "3. size   (get the number of elements in the buffer)\n"
+            << std::endl;
+        while (1) {
+            std::cout << "Input operation: ";
+            std::cin >> oper;
+            if (oper == "push") {
+                std::cin >> tmp;
+                if (!buffer.push(tmp)) {
+                    std::cout << "Buffer is full (capacity: " << buffer.capacity() << ")\n";
+                }
+            } else if (oper == "pop") {
+                if (buffer.pop(tmp)) {
+                    std::cout << "Element " << tmp << " removed.\n";
+                } else {
+                    std::cout << "Buffer is empty\n";
+                }
+            } else if (oper == "size") {
+                std::cout << buffer.size() << std::endl;
+            } else {
+                std::cout << "Invalid operation." << std::endl;
+            }
+        }
+    }
+};
+
+NS_END
@@ -0,0 +1,104 @@
+#include "RollbackDisjointSet.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::cout;
+using std::endl;
+using std::cin;
+using std::string;
+using sl::RollbackDisjointSet;
+
+RollbackDisjointSet::RollbackDisjointSet(const unsigned &size)
+    : parent(size), setSize(size, 1), sets(size) {
+    for (unsigned i = 0; i < size; ++i) {
+        parent[i] = i;
+    }
+}
+
+RollbackDisjointSet::~RollbackDisjointSet() {
+}
+
+unsigned RollbackDisjointSet::find(unsigned x) const {
+    while (parent[x] != x) {
+        x = parent[x];
+    }
+    return x;
+}
+
+bool RollbackDisjointSet::union_(const unsigned &a, const unsigned &b) {
+    unsigned root1 = find(a);
+    unsigned root2 = find(b);
+    if (root1 == root2) {
+        return false;
+    }
+    if (setSize[root1] > setSize[root2]) {
+        std::swap(root1, root2);
+    }
+    parent[root1] = root2;  // Link smaller set under larger one
+    setSize[root2] += setSize[root1];
+    history.push_back(root1);
+    --sets;
+    return true;
+}
+
+unsigned RollbackDisjointSet::snapshot() const {
+    return (unsigned)history.size();
+}
+
+void RollbackDisjointSet::rollback(const unsigned &to) {
+    if (to > history.size()) {
+        throw std::range_error("RollbackDisjointSet.rollback(): invalid snapshot");
+    }
+    while (history.size() > to) {
+        auto child = history.back();
+        history.pop_back();
+        setSize[parent[child]] -= setSize[child];
+        parent[child] = child;
+        ++sets;
+    }
+}
+
+unsigned RollbackDisjointSet::setCount() const {
+    return sets;
+}
+
+unsigned RollbackDisjointSet::size() const {
+    return (unsigned)parent.size();
+}
+
+void RollbackDisjointSet::test() {
+    cout << "Test RollbackDisjointSet:\n" << endl;
+    cin.clear();
+    RollbackDisjointSet s(10);
+    string oper;
+    cout << "Operations available:\n"
+        << "1. u a b (union a and b)\n"
+        << "2. s     (take a snapshot)\n"
+        << "3. r x   (roll back to snapshot x)\n"
+        << "4. p     (print the sets)\n"
+        << endl;
+    while (1) {
+        cout << "Input operation: ";
+        cin >> oper;
+        if (oper == "u") {
+            unsigned a, b;
+            cin >> a >> b;
+            s.union_(a, b);
+        } else if (oper == "s") {
+            cout << "Snapshot: " << s.snapshot() << endl;
+        } else if (oper == "r") {
+            unsigned to;
+            cin >> to;
+            s.rollback(to);
+        } else if (oper == "p") {
+            cout << "Sets number: " << s.setCount() << endl;
+            for (unsigned i = 0; i < s.size(); ++i) {
+                cout << "Root of vertex " << i << ": " << s.find(i) << endl;
+            }
+        } else {
+            cout << "Invalid operation." << endl;
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Base.h"
+#include <vector>
+
+NS_BEGIN
+
+/*
+A disjoint set data structure that can undo unions.
+
+Union by size without path compression keeps each find in
+O(logN), and each union changes only one parent and one size,
+which are logged on a stack. Rolling back pops the log, so each
+undone union costs O(1).
+
+For usage, see function test().
+*/
+class RollbackDisjointSet {
+public:
+    RollbackDisjointSet(const unsigned &size);
+    ~RollbackDisjointSet();
+
+    /*
+    Union two numbers to the same set.
+    (union by size)
+
+    @param a the first number
+    @param b the second number
+    @return true if the two numbers were in different sets
+    */
+    bool union_(const unsigned &a, const unsigned &b);
+
+    /*
+    Find the set that contains the number x.
+
+    @return the set index
+    */
+    unsigned find(unsigned x) const;
+
+    /*
+    Return a snapshot of current state, which is the
+    number of unions logged.
+    */
+    unsigned snapshot() const;
+
+    /*
+    Undo the unions after a snapshot.
+
+    @param to the snapshot to roll back to
+    */
+    void rollback(const unsigned &to);
+
+    /*
+    Return the number of sets.
+    */
+    unsigned setCount() const;
+
+    /*
+    Return the size of the content array.
+    */
+    unsigned size() const;
+
+private:
+    std::vector<unsigned> parent;
+    std::vector<unsigned> setSize;
+
+    // The roots linked under another root, in union order
+    std::vector<unsigned> history;
+
+    unsigned sets;
+
+public:
+    /*
+    Test the function of the class.
+
+    Sample #1 (size = 10):
+    u 2 0
+    u 2 4
+    s
+    u 3 5
+    u 5 4
+    p
+    r 2
+    p
+    */
+    static void test();
+};
+
+NS_END
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "Base.h"
+#include "Random.h"
+#include <functional>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+NS_BEGIN
+
+/*
+A skip list data structure used as an ordered set.
+
+Each node has a random level. Level i of the list links the
+nodes whose level is larger than i, so a search goes down from
+the sparse top level and skips most of the nodes.
+(expected time complexity of search, insert, remove: O(logN))
+
+Type T must overload:
+1. operator <  for comparing.
+2. operator << for running test. (not compulsory)
+3. operator >> for running test. (not compulsory)
+
+For a version that supports concurrent writers, see LockFreeSkipList.
+
+For usage, see function test().
+*/
+template <typename T>
+class SkipList {
+public:
+    // Max level of the nodes
+    static const int MAX_LEVEL = 32;
+
+    /*
+    Definition of the list node.
+    The next pointers are allocated together with the node.
+    */
+    struct ListNode {
+        T val;
+        int level;
+        ListNode *next[1];
+    };
+
+    SkipList() : level(1), size_(0), head(createNode(T(), MAX_LEVEL)) {  // Use fake head
+    }
+
+    ~SkipList() {
+        release();
+    }
+
+    /*
+    Forbid copy.
+    */
+    SkipList(const SkipList<T> &l) = delete;
+    SkipList<T>& operator=(const SkipList<T> &l) = delete;
+
+    /*
+    Return the number of elements in the list.
+    */
+    unsigned long long size() const {
+        return size_;
+    }
+
+    /*
+    Return whether the list is empty.
+    */
+    bool isEmpty() const {
+        return size_ == 0;
+    }
+
+    /*
+    Check if element ele is in the list.
+
+    @param ele the element to check.
+    @return true if the element is in the list, false otherwise.
+    */
+    bool has(const T &ele) const {
+        auto node = lowerBound(ele);
+        return node && !(ele < node->val);
+    }
+
+    /*
+    Return the minimum element of the list.
+    */
+    T min() const {
+        if (isEmpty()) {
+            throw std::range_error("SkipList.min(): list is empty");
+        }
+        return head->next[0]->val;
+    }
+
+    /*
+    Return the maximum element of the list.
+    */
+    T max() const {
+        if (isEmpty()) {
+            throw std::range_error("SkipList.max(): list is empty");
+        }
+        const ListNode *tmp = head;
+        for (int i = level - 1; i >= 0; --i) {
+            while (tmp->next[i]) {
+                tmp = tmp->next[i];
+            }
+        }
+        return tmp->val;
+    }
+
+    /*
+    Insert an element into the list.
+    If the element exists, do nothing.
+
+    @param ele the element to insert.
+    @return true if the element is inserted, false if it exists.
+    */
+    bool insert(const T &ele) {
+        ListNode *update[MAX_LEVEL];
+        auto node = findPrevNodes(ele, update);
+        if (node && !(ele < node->val)) {
+            return false;
+        }
+        int lv = randomLevel();
+        for (; level < lv; ++level) {
+            update[level] = head;
+        }
+        node = createNode(ele, lv);
+        for (int i = 0; i < lv; ++i) {
+            node->next[i] = update[i]->next[i];
+            update[i]->next[i] = node;
+        }
+        ++size_;
+        return true;
+    }
+
+    /*
+    Remove an element from the list.
+
+    @param ele the element to remove.
+    @return true if the element is removed, false if not found.
+    */
+    bool remove(const T &ele) {
+        ListNode *update[MAX_LEVEL];
+        auto node = findPrevNodes(ele, update);
+        if (!node || ele < node->val) {
+            return false;
+        }
+        for (int i = 0; i < node->level; ++i) {
+            update[i]->next[i] = node->next[i];
+        }
+        while (level > 1 && !head->next[level - 1]) {
+            --level;
+        }
+        destroyNode(node);
+        --size_;
+        return true;
+    }
+
+    /*
+    Traverse the elements in ascending order.
+
+    @param f the function to manipulate each element
+    */
+    void traverse(const std::function<void(const T&)> &f) const {
+        for (auto tmp = head->next[0]; tmp; tmp = tmp->next[0]) {
+            f(tmp->val);
+        }
+    }
+
+    /*
+    Traverse the elements in range [low, high] in ascending order.
+
+    @param low the lower bound of the range
+    @param high the upper bound of the range
+    @param f the function to manipulate each element
+    */
+    void traverseInRange(const T &low, const T &high,
+                         const std::function<void(const T&)> &f) const {
+        for (auto tmp = lowerBound(low); tmp && !(high < tmp->val); tmp = tmp->next[0]) {
+            f(tmp->val);
+        }
+    }
+
+private:
+    // Probability for a node to have one more level
+    static constexpr double P = 0.5;
+
+    // Current max level of the nodes in the list
+    int level;
+
+    unsigned long long size_;
+
+    ListNode *head;
+
+    /*
+    Allocate a node with its next pointers.
+
+    @param v the value of the node
+    @param lv the level of the node
+    @return the node created
+    */
+    static ListNode* createNode(const T &v, const int lv) {
+        void *mem = ::operator new(sizeof(ListNode) + (lv - 1) * sizeof(ListNode*));
+        auto node = static_cast<ListNode*>(mem);
+        new (&node->val) T(v);
+        node->level = lv;
+        for (int i = 0; i < lv; ++i) {
+            node->next[i] = nullptr;
+        }
+        return node;
+    }
+
+    /*
+    Release a node created by createNode().
+    */
+    static void destroyNode(ListNode *node) {
+        node->val.~T();
+        ::operator delete(node);
+    }
+
+    /*
+    Release the memory space.
+    */
+    void release() {
+        ListNode *tmp = head, *del;
+        while (tmp) {
+            del = tmp;
+            tmp = tmp->next[0];
+            destroyNode(del);
+        }
+        head = nullptr;
+    }
+
+    /*
+    Return a random level in [1, MAX_LEVEL]
+    with P(level > i) = P^i.
+    */
+    int randomLevel() const {
+        int lv = 1;
+        auto random = Random::getInstance();
+        while (lv < MAX_LEVEL && random->rand() < P) {
+            ++lv;
+        }
+        return lv;
+    }
+
+    /*
+    Find the last node smaller than an element at each level.
+
+    @param ele the element to find
+    @param update the result will be stored in update[0, level)
+    @return the first node not smaller than the element,
+            nullptr if there is no such node
+    */
+    ListNode* findPrevNodes(const T &ele, ListNode **update) const {
+        ListNode *tmp = head;
+        for (int i = level - 1; i >= 0; --i) {
+            while (tmp->next[i] && tmp->next[i]->val < ele) {
+                tmp = tmp->next[i];
+            }
+            update[i] = tmp;
+        }
+        return tmp->next[0];
+    }
+
+    /*
+    Return the first node not smaller than an element,
+    nullptr if there is no such node.
+    */
+    const ListNode* lowerBound(const T &ele) const {
+        const ListNode *tmp = head;
+        for (int i = level - 1; i >= 0; --i) {
+            while (tmp->next[i] && tmp->next[i]->val < ele) {
+                tmp = tmp->next[i];
+            }
+        }
+        return tmp->next[0];
+    }
+
+public:
+    /*
+    Test the function of the class.
+
+    Sample #1:
+    i 3
+    i 2
+    i 1
+    i 4
+    i 5
+    i 6
+    i 7
+    i 16
+    i 15
+    i 14
+    range 5 14
+
+    Result:
+    5 6 7 14
+    */
+    static void test() {
+        std::cout << "Test SkipList:\n\n";
+        std::cin.clear();
+        SkipList<T> list;
+        T tmp, tmp2;
+        std::string oper;
+        auto f = [](const T &ele) {
+            std::cout << ele << " ";
+        };
+        std::cout << "Operations available:\n"
+            << "1. i x       (insert element x)\n"
+            << "2. f x       (find element x)\n"
+            << "3. r x       (remove element x)\n"
+            << "4. p         (print the elements in order)\n"
+            << "5. range a b (print the elements in range [a, b])\n"
+            << "6. min       (print the minimum element of the list)\n"
+            << "7. max       (print the maximum element of the list)\n"
+            << "8. size      (get the number of elements in the list)\n"
+            << std::endl;
+        while (1) {
+            std::cout << "Input operation: ";
+            std::cin >> oper;
+            if (oper == "i") {
+                std::cin >> tmp;
+                list.insert(tmp);
+            } else if (oper == "f") {
+                std::cin >> tmp;
+                if (list.has(tmp)) {
+                    std::cout << "Element " << tmp << " found\n";
+                } else {
+                    std::cout << "Element " << tmp << " not found\n";
+                }
+            } else if (oper == "r") {
+                std::cin >> tmp;
+                if (list.remove(tmp)) {
+                    std::cout << "Element " << tmp << " removed\n";
+                } else {
+                    std::cout << "Element " << tmp << " not found\n";
+                }
+            } else if (oper == "p") {
+                list.traverse(f);
+                std::cout << std::endl;
+            } else if (oper == "range") {
+                std::cin >> tmp >> tmp2;
+                list.traverseInRange(tmp, tmp2, f);
+                std::cout << std::endl;
+            } else if (oper == "min") {
+                std::cout << list.min() << std::endl;
+            } else if (oper == "max") {
+                std::cout << list.max() << std::endl;
+            } else if (oper == "size") {
+                std::cout << list.size() << std::endl;
+            } else {
+                std::cout << "Invalid operation." << std::endl;
+            }
+        }
+    }
+};
+
+NS_END
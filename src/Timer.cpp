@@ -7,9 +7,10 @@ Timer::Timer() {
 }
 
 void Timer::reset() {
-    begin = clock();
+    begin = std::chrono::steady_clock::now();
 }
 
 double Timer::elapse() {
-    return 1000 * (clock() - begin) / (double)CLOCKS_PER_SEC;
+    std::chrono::duration<double, std::milli> d = std::chrono::steady_clock::now() - begin;
+    return d.count();
 }
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "Base.h"
-#include <ctime>
+#include <chrono>
 
 NS_BEGIN
 
 /*
 A class used for compute running time.
+Wall clock time is measured so that multi-threaded code
+is timed correctly.
 */
 class Timer {
 public:
@@ -23,7 +25,7 @@ public:
     double elapse();
 
 private:
-    clock_t begin;
+    std::chrono::steady_clock::time_point begin;
 };
 
 NS_END
@@ -1,9 +1,16 @@
 #include "Base.h"
 #include "LinkedList.h"
+#include "LockFreeQueue.h"
+#include "RingBuffer.h"
 #include "BinaryHeap.h"
 #include "HashTable.h"
 #include "AVLTree.h"
+#include "SkipList.h"
+#include "LockFreeSkipList.h"
 #include "DisjointSet.h"
+#include "ConcurrentDisjointSet.h"
+#include "RollbackDisjointSet.h"
+#include "DynamicConnectivity.h"
 #include "Graph.h"
 #include "SortHelper.h"
 #include "Random.h"
@@ -13,15 +20,26 @@
 #include "NQueen.h"
 #include "Algorithm.h"
 #include "AlgorithmGraph.h"
+#include "PointToPointQuery.h"
+#include "ContractionHierarchy.h"
+#include "DynamicShortestPath.h"
+#include "FlowNetwork.h"
 
 using namespace sl;
 
 void test() {
     //LinkedList<int>::test();
+    //LockFreeQueue<int>::test();
+    //RingBuffer<int>::test();
     //BinaryHeap<int>::test();
     //HashTable<int>::test();
     //AVLTree<int>::test();
+    //SkipList<int>::test();
+    //LockFreeSkipList<int>::test();
     //DisjointSet::test();
+    //ConcurrentDisjointSet::test();
+    //RollbackDisjointSet::test();
+    //DynamicConnectivity::test();
     //Graph::test();
     //SortHelper<int>::test();
     //Random::test();
@@ -31,6 +49,10 @@ void test() {
     //NQueen::test();
     //Algorithm::test();
     //AlgorithmGraph::test();
+    //PointToPointQuery::test();
+    //ContractionHierarchy::test();
+    //DynamicShortestPath::test();
+    //FlowNetwork::test();
 }
 
 int main() {